@@ -0,0 +1,32 @@
+# Make counterpart of binding.cmake, used by make-based ports
+
+# Location of the binding and of LVGL
+LVGL_BINDINGS_DIR := $(LVGL_ESP32_MOD_DIR)/binding
+LVGL_ROOT_DIR := $(LVGL_BINDINGS_DIR)/lvgl
+
+# Generated bindings, the preprocessed input and the bindings metadata
+LVGL_MPY := $(BUILD)/lvgl/lv_mp.c
+LVGL_MPY_PP := $(LVGL_MPY).pp
+LVGL_MPY_METADATA := $(LVGL_MPY).json
+
+LVGL_LVGL_H := $(LVGL_ROOT_DIR)/lvgl.h
+LVGL_GEN_MPY := $(LVGL_BINDINGS_DIR)/gen/gen_mpy.py
+LVGL_FAKE_LIBC := $(LVGL_BINDINGS_DIR)/pycparser/utils/fake_libc_include
+
+# Gather the headers
+LVGL_HEADERS := $(shell find $(LVGL_ROOT_DIR)/src -type f -name '*.h') $(LVGL_BINDINGS_DIR)/lv_conf.h
+
+# Preprocess and generate the bindings
+$(LVGL_MPY): $(LVGL_LVGL_H) $(LVGL_HEADERS) $(LVGL_GEN_MPY)
+	$(ECHO) "LVGL-GEN $@"
+	$(Q)mkdir -p $(dir $@)
+	$(Q)$(CPP) -DPYCPARSER -x c -I $(LVGL_FAKE_LIBC) $(CFLAGS_USERMOD) $(LVGL_LVGL_H) > $(LVGL_MPY_PP)
+	$(Q)$(PYTHON) $(LVGL_GEN_MPY) -M lvgl -MP lv -MD $(LVGL_MPY_METADATA) -E $(LVGL_MPY_PP) $(LVGL_LVGL_H) > $@ \
+		|| (rm -f $@ && /bin/false)
+
+# Build LVGL itself and the generated bindings
+SRC_USERMOD_LIB_C += $(subst $(TOP)/,,$(shell find $(LVGL_ROOT_DIR)/src -type f -name '*.c'))
+SRC_USERMOD_C += $(LVGL_MPY)
+
+CFLAGS_USERMOD += -I$(LVGL_BINDINGS_DIR)
+CFLAGS_USERMOD += -Wno-unused-function
@@ -1009,6 +1009,7 @@ typedef struct mp_lv_obj_type_t {{
 
 static const mp_lv_obj_type_t mp_lv_{base_obj}_type;
 static const mp_lv_obj_type_t *mp_lv_obj_types[];
+static const mp_obj_type_t *mp_lv_obj_type_lookup(const lv_obj_class_t *lv_obj_class);
 
 static inline const mp_obj_type_t *get_BaseObj_type()
 {{
@@ -1037,6 +1038,22 @@ print(
 #endif // __GNUC__
 #endif // GENMPY_UNUSED
 
+// Hooks around Python callbacks, for example to take the GIL when LVGL calls back from another thread
+
+#ifndef GENMPY_CALLBACK_ENTER
+#define GENMPY_CALLBACK_ENTER()
+#endif
+
+#ifndef GENMPY_CALLBACK_EXIT
+#define GENMPY_CALLBACK_EXIT()
+#endif
+
+// Runs instead of GENMPY_CALLBACK_EXIT when the callback raises, right before the exception is passed on
+
+#ifndef GENMPY_CALLBACK_RAISE
+#define GENMPY_CALLBACK_RAISE() GENMPY_CALLBACK_EXIT()
+#endif
+
 // Custom function mp object
 
 typedef mp_obj_t (*mp_fun_ptr_var_t)(size_t n, const mp_obj_t *, void *ptr);
@@ -1160,6 +1177,33 @@ static mp_obj_t cast(mp_obj_t mp_obj, const mp_obj_type_t *mp_type)
     return res;
 }
 
+// LVGL memory outside of the MicroPython heap, like the pool of its builtin allocator, is not scanned by the GC. The
+// Python objects that only LVGL refers to are then kept in a dict under a root pointer, keyed by their address.
+
+#ifndef GENMPY_KEEP_LV_REFS
+#define GENMPY_KEEP_LV_REFS (LV_USE_STDLIB_MALLOC != LV_STDLIB_MICROPYTHON)
+#endif
+
+MP_REGISTER_ROOT_POINTER(mp_obj_t mp_lv_refs);
+
+static void mp_lv_keep(void *ptr)
+{
+#if GENMPY_KEEP_LV_REFS
+    if (MP_STATE_VM(mp_lv_refs) == MP_OBJ_NULL) MP_STATE_VM(mp_lv_refs) = mp_obj_new_dict(0);
+    // Objects are aligned to words, so the address shifted right fits in a small int
+    mp_obj_dict_store(MP_STATE_VM(mp_lv_refs), MP_OBJ_NEW_SMALL_INT((uintptr_t)ptr >> 2), MP_OBJ_FROM_PTR(ptr));
+#endif
+}
+
+GENMPY_UNUSED static void mp_lv_release(void *ptr)
+{
+#if GENMPY_KEEP_LV_REFS
+    if (ptr == NULL || MP_STATE_VM(mp_lv_refs) == MP_OBJ_NULL) return;
+    mp_map_lookup(mp_obj_dict_get_map(MP_STATE_VM(mp_lv_refs)), MP_OBJ_NEW_SMALL_INT((uintptr_t)ptr >> 2),
+        MP_MAP_LOOKUP_REMOVE_IF_FOUND);
+#endif
+}
+
 // object handling
 // This section is enabled only when objects are supported
 
@@ -1169,6 +1213,7 @@ typedef struct mp_lv_obj_t {
     mp_obj_base_t base;
     LV_OBJ_T *lv_obj;
     LV_OBJ_T *callbacks;
+    struct mp_lv_obj_t *next_cast; // Wrappers of the same object as other types, chained from the one in user_data
 } mp_lv_obj_t;
 
 static inline LV_OBJ_T *mp_to_lv(mp_obj_t mp_obj)
@@ -1204,10 +1249,15 @@ static void mp_lv_delete_cb(lv_event_t * e)
 {
     LV_OBJ_T *lv_obj = e->current_target;
     if (lv_obj){
-        mp_lv_obj_t *self = lv_obj->user_data;
-        if (self) {
+        for (mp_lv_obj_t *self = lv_obj->user_data; self; self = self->next_cast) {
             self->lv_obj = NULL;
         }
+
+        // LVGL lets go of the wrapper and of the callback dicts of the events of the object
+        for (uint32_t i = 0; i < lv_obj_get_event_count(lv_obj); i++) {
+            mp_lv_release(lv_event_dsc_get_user_data(lv_obj_get_event_dsc(lv_obj, i)));
+        }
+        mp_lv_release(lv_obj->user_data);
     }
 }
 
@@ -1218,15 +1268,8 @@ static inline mp_obj_t lv_to_mp(LV_OBJ_T *lv_obj)
     if (!self)
     {
         // Find the object type
-        const mp_obj_type_t *mp_obj_type = get_BaseObj_type();
-        const lv_obj_class_t *lv_obj_class = lv_obj_get_class(lv_obj);
-        const mp_lv_obj_type_t **iter = &mp_lv_obj_types[0];
-        for (; *iter; iter++) {
-            if ((*iter)->lv_obj_class == lv_obj_class) {
-                mp_obj_type = (*iter)->mp_obj_type;
-                break;
-            }
-        }
+        const mp_obj_type_t *mp_obj_type = mp_lv_obj_type_lookup(lv_obj_get_class(lv_obj));
+        if (!mp_obj_type) mp_obj_type = get_BaseObj_type();
 
         // Create the MP object
         self = m_new_obj(mp_lv_obj_t);
@@ -1234,10 +1277,12 @@ static inline mp_obj_t lv_to_mp(LV_OBJ_T *lv_obj)
             .base = {(const mp_obj_type_t *)mp_obj_type},
             .lv_obj = lv_obj,
             .callbacks = NULL,
+            .next_cast = NULL,
         };
 
         // Register the Python object in user_data
         lv_obj->user_data = self;
+        mp_lv_keep(self);
 
         // Register a "Delete" event callback
         lv_obj_add_event_cb(lv_obj, mp_lv_delete_cb, LV_EVENT_DELETE, NULL);
@@ -1247,15 +1292,33 @@ static inline mp_obj_t lv_to_mp(LV_OBJ_T *lv_obj)
 
 static void* mp_to_ptr(mp_obj_t self_in);
 
+// Casts of a live object return the same wrapper every time: the one in user_data when the type matches, otherwise one
+// from its chain of casts, so only the first cast of an object to a type allocates. Anything else, like a display or an
+// input device given as an event target, is only wrapped: its user_data is not ours to use.
 static mp_obj_t cast_obj_type(const mp_obj_type_t* type, mp_obj_t obj)
 {
+    LV_OBJ_T *lv_obj = mp_to_ptr(obj);
+    if (!lv_obj) return mp_const_none;
+
+    mp_lv_obj_t *canonical = NULL;
+    if (lv_obj_is_valid(lv_obj)) {
+        canonical = MP_OBJ_TO_PTR(lv_to_mp(lv_obj));
+        for (mp_lv_obj_t *self = canonical; self; self = self->next_cast) {
+            if (self->base.type == type) return MP_OBJ_FROM_PTR(self);
+        }
+    }
+
     mp_lv_obj_t *self = m_new_obj(mp_lv_obj_t);
     *self = (mp_lv_obj_t){
         .base = {type},
-        .lv_obj = mp_to_ptr(obj),
+        .lv_obj = lv_obj,
         .callbacks = NULL,
+        .next_cast = NULL,
     };
-    if (!self->lv_obj) return mp_const_none;
+    if (canonical) {
+        self->next_cast = canonical->next_cast;
+        canonical->next_cast = self;
+    }
     return MP_OBJ_FROM_PTR(self);
 }
 
@@ -1285,9 +1348,14 @@ static mp_obj_t make_new(
     if (!lv_obj) return mp_const_none;
 
     mp_lv_obj_t *self = MP_OBJ_TO_PTR(lv_obj);
-    if (self->base.type != type)
-        return cast_obj_type(type, lv_obj);
-    return lv_obj;
+    if (self->base.type == type) return lv_obj;
+
+    // The object was just created, so its wrapper can simply become the requested type instead of a second allocation
+    if (self->next_cast == NULL) {
+        self->base.type = type;
+        return lv_obj;
+    }
+    return cast_obj_type(type, lv_obj);
 }
 
 static MP_DEFINE_CONST_FUN_OBJ_2(cast_obj_obj, cast_obj);
@@ -1727,13 +1795,17 @@ static void *mp_lv_callback(mp_obj_t mp_callback, void *lv_callback, qstr callba
         void *user_data = NULL;
         if (user_data_ptr) {
             // user_data is either a dict of callbacks in case of struct, or a pointer to mp_lv_obj_t in case of lv_obj_t
-            if (! (*user_data_ptr) ) *user_data_ptr = MP_OBJ_TO_PTR(mp_obj_new_dict(0)); // if it's NULL - it's a dict for a struct
+            if (! (*user_data_ptr) ) { // if it's NULL - it's a dict for a struct
+                *user_data_ptr = MP_OBJ_TO_PTR(mp_obj_new_dict(0));
+                mp_lv_keep(*user_data_ptr);
+            }
             user_data = *user_data_ptr;
         }
         else if (get_user_data && set_user_data) {
             user_data = get_user_data(containing_struct);
             if (!user_data) {
                 user_data = MP_OBJ_TO_PTR(mp_obj_new_dict(0));
+                mp_lv_keep(user_data);
                 set_user_data(containing_struct, user_data);
             }
         }
@@ -2831,12 +2903,22 @@ def gen_callback_func(func, func_name=None, user_data_argument=False):
 
 GENMPY_UNUSED static {return_type} {func_name}_callback({func_args})
 {{
+    GENMPY_CALLBACK_ENTER();
+    nlr_buf_t callback_nlr;
+    if (nlr_push(&callback_nlr) != 0)
+    {{
+        GENMPY_CALLBACK_RAISE();
+        nlr_jump(callback_nlr.ret_val);
+    }}
     mp_obj_t mp_args[{num_args}];
     {build_args}
     mp_obj_t callbacks = get_callback_dict_from_user_data({user_data});
     _nesting++;
     {return_value_assignment}mp_call_function_n_kw(mp_obj_dict_get(callbacks, MP_OBJ_NEW_QSTR(MP_QSTR_{func_name})) , {num_args}, 0, mp_args);
     _nesting--;
+    {return_value_conversion}
+    nlr_pop();
+    GENMPY_CALLBACK_EXIT();
     return{return_value};
 }}
 """.format(
@@ -2855,9 +2937,12 @@ GENMPY_UNUSED static {return_type} {func_name}_callback({func_args})
             return_value_assignment=""
             if return_type == "void"
             else "mp_obj_t callback_result = ",
+            return_value_conversion=""
+            if return_type == "void"
+            else "%s callback_return = %s(callback_result);" % (return_type, mp_to_lv[return_type]),
             return_value=""
             if return_type == "void"
-            else " %s(callback_result)" % mp_to_lv[return_type],
+            else " callback_return",
         )
     )
     generated_callbacks[func_name] = True
@@ -3699,10 +3784,48 @@ static const mp_lv_obj_type_t *mp_lv_obj_types[] = {{
     {obj_types},
     NULL
 }};
+
+// Open addressing hash table from LVGL class to object type, filled from mp_lv_obj_types on first use.
+// lv_to_mp() looks up the type of every object that shows up in Python for the first time.
+#define MP_LV_OBJ_TYPE_TABLE_SIZE {table_size}
+
+static const mp_lv_obj_type_t *mp_lv_obj_type_table[MP_LV_OBJ_TYPE_TABLE_SIZE];
+
+static inline size_t mp_lv_obj_type_hash(const lv_obj_class_t *lv_obj_class)
+{{
+    uint32_t hash = (uint32_t)(uintptr_t)lv_obj_class;
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3b;
+    hash ^= hash >> 16;
+    return hash & (MP_LV_OBJ_TYPE_TABLE_SIZE - 1);
+}}
+
+static const mp_obj_type_t *mp_lv_obj_type_lookup(const lv_obj_class_t *lv_obj_class)
+{{
+    static bool mp_lv_obj_type_table_initialized = false;
+    if (!mp_lv_obj_type_table_initialized) {{
+        for (const mp_lv_obj_type_t **iter = &mp_lv_obj_types[0]; *iter; iter++) {{
+            if (!(*iter)->lv_obj_class) continue;
+            size_t i = mp_lv_obj_type_hash((*iter)->lv_obj_class);
+            while (mp_lv_obj_type_table[i] && mp_lv_obj_type_table[i]->lv_obj_class != (*iter)->lv_obj_class)
+                i = (i + 1) & (MP_LV_OBJ_TYPE_TABLE_SIZE - 1);
+            // Like a scan of mp_lv_obj_types, the first type of a class wins
+            if (!mp_lv_obj_type_table[i]) mp_lv_obj_type_table[i] = *iter;
+        }}
+        mp_lv_obj_type_table_initialized = true;
+    }}
+
+    for (size_t i = mp_lv_obj_type_hash(lv_obj_class); mp_lv_obj_type_table[i]; i = (i + 1) & (MP_LV_OBJ_TYPE_TABLE_SIZE - 1)) {{
+        if (mp_lv_obj_type_table[i]->lv_obj_class == lv_obj_class) return mp_lv_obj_type_table[i]->mp_obj_type;
+    }}
+    return NULL;
+}}
     """.format(
             obj_types=",\n    ".join(
                 ["&mp_lv_%s_type" % obj_name for obj_name in obj_names]
-            )
+            ),
+            # At most half full, so probe sequences stay short
+            table_size=1 << (2 * len(obj_names)).bit_length(),
         )
     )
 
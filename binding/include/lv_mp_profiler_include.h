@@ -0,0 +1,22 @@
+#ifndef __LV_MP_PROFILER_INCLUDE_H
+#define __LV_MP_PROFILER_INCLUDE_H
+
+#include <stdbool.h>
+
+/*Profiler points of LVGL and of the lvgl_esp32 module go to the trace ring in src/trace.c. While tracing is off they
+ *only test a flag.*/
+extern volatile bool lvgl_esp32_trace_enabled;
+void lvgl_esp32_trace_event(const char *name, char phase);
+
+#define LVGL_ESP32_TRACE(name, phase)               \
+    do {                                            \
+        if (lvgl_esp32_trace_enabled) {             \
+            lvgl_esp32_trace_event(name, phase);    \
+        }                                           \
+    } while (0)
+
+#define LVGL_ESP32_TRACE_BEGIN(name)    LVGL_ESP32_TRACE(name, 'B')
+#define LVGL_ESP32_TRACE_END(name)      LVGL_ESP32_TRACE(name, 'E')
+#define LVGL_ESP32_TRACE_INSTANT(name)  LVGL_ESP32_TRACE(name, 'i')
+
+#endif //__LV_MP_PROFILER_INCLUDE_H
@@ -64,7 +64,22 @@
  * - LV_STDLIB_RTTHREAD:    RT-Thread implementation
  * - LV_STDLIB_CUSTOM:      Implement the functions externally
  */
-#define LV_USE_STDLIB_MALLOC    LV_STDLIB_MICROPYTHON
+/*LVGL_ESP32_MEM_POOL has LVGL use its builtin allocator on a pool outside of the MicroPython heap, so the GC neither
+ *sweeps nor walks the many small allocations of LVGL. The binding keeps the Python objects LVGL refers to reachable.
+ *LVGL_ESP32_USE_OS runs LVGL in its own task (see the README), which must not touch the MicroPython GC heap and so
+ *always uses the pool.*/
+#ifndef LVGL_ESP32_USE_OS
+    #define LVGL_ESP32_USE_OS 0
+#endif
+#ifndef LVGL_ESP32_MEM_POOL
+    #define LVGL_ESP32_MEM_POOL LVGL_ESP32_USE_OS
+#endif
+
+#if (LVGL_ESP32_MEM_POOL || LVGL_ESP32_USE_OS) && !defined(PYCPARSER)
+    #define LV_USE_STDLIB_MALLOC    LV_STDLIB_BUILTIN
+#else
+    #define LV_USE_STDLIB_MALLOC    LV_STDLIB_MICROPYTHON
+#endif
 #define LV_USE_STDLIB_STRING    LV_STDLIB_BUILTIN
 #define LV_USE_STDLIB_SPRINTF   LV_STDLIB_BUILTIN
 
@@ -76,8 +91,12 @@
 #define LV_STDARG_INCLUDE       <stdarg.h>
 
 #if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
-    /*Size of the memory available for `lv_malloc()` in bytes (>= 2kB)*/
-    #define LV_MEM_SIZE (64 * 1024U)          /*[bytes]*/
+    /*Size of the memory available for `lv_malloc()` in bytes (>= 2kB), Wrapper(mem_size=...) can add to it*/
+    #ifdef LVGL_ESP32_MEM_SIZE
+        #define LV_MEM_SIZE LVGL_ESP32_MEM_SIZE
+    #else
+        #define LV_MEM_SIZE (64 * 1024U)          /*[bytes]*/
+    #endif
 
     /*Size of the memory expand for `lv_malloc()` in bytes*/
     #define LV_MEM_POOL_EXPAND_SIZE 0
@@ -86,8 +105,10 @@
     #define LV_MEM_ADR 0     /*0: unused*/
     /*Instead of an address give a memory allocator that will be called to get a memory pool for LVGL. E.g. my_malloc*/
     #if LV_MEM_ADR == 0
-        #undef LV_MEM_POOL_INCLUDE
-        #undef LV_MEM_POOL_ALLOC
+        #define LV_MEM_POOL_INCLUDE <stddef.h>
+        #include LV_MEM_POOL_INCLUDE
+        extern void *lvgl_esp32_mem_pool_alloc(size_t size);
+        #define LV_MEM_POOL_ALLOC lvgl_esp32_mem_pool_alloc
     #endif
 #endif  /*LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN*/
 
@@ -113,7 +134,15 @@
  * - LV_OS_RTTHREAD
  * - LV_OS_WINDOWS
  * - LV_OS_CUSTOM */
-#define LV_USE_OS   LV_OS_NONE
+#if LVGL_ESP32_USE_OS && !defined(PYCPARSER)
+    #ifdef ESP_PLATFORM
+        #define LV_USE_OS   LV_OS_FREERTOS
+    #else
+        #define LV_USE_OS   LV_OS_PTHREAD
+    #endif
+#else
+    #define LV_USE_OS   LV_OS_NONE
+#endif
 
 #if LV_USE_OS == LV_OS_CUSTOM
     #define LV_OS_CUSTOM_INCLUDE <stdint.h>
@@ -137,12 +166,29 @@
 /*The target buffer size for simple layer chunks.*/
 #define LV_DRAW_LAYER_SIMPLE_BUF_SIZE    (24 * 1024)   /*[bytes]*/
 
+/* Stack size of the drawing threads, used when LV_DRAW_SW_DRAW_UNIT_CNT > 1.
+ * NOTE: If FreeType or ThorVG is enabled, it is recommended to set it to 32KB or more. */
+#define LV_DRAW_THREAD_STACK_SIZE    (8 * 1024)   /*[bytes]*/
+
 #define LV_USE_DRAW_SW 1
 #if LV_USE_DRAW_SW == 1
     /* Set the number of draw unit.
      * > 1 requires an operating system enabled in `LV_USE_OS`
-     * > 1 means multiply threads will render the screen in parallel */
-    #define LV_DRAW_SW_DRAW_UNIT_CNT    1
+     * > 1 means multiply threads will render the screen in parallel
+     * With LVGL_ESP32_USE_OS one unit per core renders the tiles of a frame, override with LVGL_ESP32_DRAW_UNITS */
+    #ifndef LVGL_ESP32_DRAW_UNITS
+        #if LV_USE_OS != LV_OS_NONE
+            #define LVGL_ESP32_DRAW_UNITS   2
+        #else
+            #define LVGL_ESP32_DRAW_UNITS   1
+        #endif
+    #endif
+
+    #if LVGL_ESP32_DRAW_UNITS > 1 && LV_USE_OS == LV_OS_NONE && !defined(PYCPARSER)
+        #error "LVGL_ESP32_DRAW_UNITS > 1 requires LVGL_ESP32_USE_OS"
+    #endif
+
+    #define LV_DRAW_SW_DRAW_UNIT_CNT    LVGL_ESP32_DRAW_UNITS
 
     /* Use Arm-2D to accelerate the sw render */
     #define LV_USE_DRAW_ARM2D_SYNC      0
@@ -325,6 +371,20 @@
 extern void mp_lv_init_gc();
 #define LV_GC_INIT() mp_lv_init_gc()
 
+/*Hooks around every Python callback in the generated binding, used to take the GIL when LVGL runs in its own task*/
+#if LVGL_ESP32_USE_OS && !defined(PYCPARSER)
+    extern void lvgl_esp32_callback_enter(void);
+    extern void lvgl_esp32_callback_exit(void);
+    extern void lvgl_esp32_callback_raise(void);
+    #define GENMPY_CALLBACK_ENTER() lvgl_esp32_callback_enter()
+    #define GENMPY_CALLBACK_EXIT() lvgl_esp32_callback_exit()
+    #define GENMPY_CALLBACK_RAISE() lvgl_esp32_callback_raise()
+#elif !defined(PYCPARSER)
+    /*Otherwise they only mark the callback in the trace*/
+    #define GENMPY_CALLBACK_ENTER() LV_PROFILER_BEGIN_TAG("python_callback")
+    #define GENMPY_CALLBACK_EXIT() LV_PROFILER_END_TAG("python_callback")
+#endif
+
 #define LV_ENABLE_GLOBAL_CUSTOM 1
 #if LV_ENABLE_GLOBAL_CUSTOM
     extern void *mp_lv_roots;
@@ -843,30 +903,36 @@ extern void mp_lv_init_gc();
 
 #endif /*LV_USE_SYSMON*/
 
-/*1: Enable the runtime performance profiler*/
-#define LV_USE_PROFILER 0
+/*1: Enable the runtime performance profiler
+ *Its points feed the trace ring of the lvgl_esp32 module (Wrapper.trace_start(), see the README). The binding
+ *generator does not need to see it.*/
+#if !defined(PYCPARSER)
+    #define LV_USE_PROFILER 1
+#else
+    #define LV_USE_PROFILER 0
+#endif
 #if LV_USE_PROFILER
     /*1: Enable the built-in profiler*/
-    #define LV_USE_PROFILER_BUILTIN 1
+    #define LV_USE_PROFILER_BUILTIN 0
     #if LV_USE_PROFILER_BUILTIN
         /*Default profiler trace buffer size*/
         #define LV_PROFILER_BUILTIN_BUF_SIZE (16 * 1024)     /*[bytes]*/
     #endif
 
     /*Header to include for the profiler*/
-    #define LV_PROFILER_INCLUDE "lvgl/src/misc/lv_profiler_builtin.h"
+    #define LV_PROFILER_INCLUDE "include/lv_mp_profiler_include.h"
 
     /*Profiler start point function*/
-    #define LV_PROFILER_BEGIN    LV_PROFILER_BUILTIN_BEGIN
+    #define LV_PROFILER_BEGIN    LVGL_ESP32_TRACE_BEGIN(__func__)
 
     /*Profiler end point function*/
-    #define LV_PROFILER_END      LV_PROFILER_BUILTIN_END
+    #define LV_PROFILER_END      LVGL_ESP32_TRACE_END(__func__)
 
     /*Profiler start point function with custom tag*/
-    #define LV_PROFILER_BEGIN_TAG LV_PROFILER_BUILTIN_BEGIN_TAG
+    #define LV_PROFILER_BEGIN_TAG LVGL_ESP32_TRACE_BEGIN
 
     /*Profiler end point function with custom tag*/
-    #define LV_PROFILER_END_TAG   LV_PROFILER_BUILTIN_END_TAG
+    #define LV_PROFILER_END_TAG   LVGL_ESP32_TRACE_END
 #endif
 
 /*1: Enable Monkey test*/
@@ -0,0 +1,66 @@
+# Renders screens that stress the complex software renderer and reports the time per frame. Run it on firmwares built
+# with different LVGL_ESP32_DRAW_UNITS to see what parallel rendering gains.
+import time
+
+from .hardware import display
+
+import lvgl as lv
+import lvgl_esp32
+
+FRAMES = 50
+
+wrapper = lvgl_esp32.Wrapper(display)
+wrapper.init()
+
+screen = lv.screen_active()
+
+
+def shadows(parent):
+    for i in range(6):
+        obj = lv.obj(parent)
+        obj.set_size(80, 50)
+        obj.set_pos(15 + (i % 3) * 100, 20 + (i // 3) * 110)
+        obj.set_style_radius(12, lv.PART.MAIN)
+        obj.set_style_shadow_width(30, lv.PART.MAIN)
+        obj.set_style_shadow_spread(4, lv.PART.MAIN)
+        obj.set_style_shadow_color(lv.color_hex(0x202020), lv.PART.MAIN)
+
+
+def arcs(parent):
+    for i in range(6):
+        arc = lv.arc(parent)
+        arc.set_size(90, 90)
+        arc.set_pos(10 + (i % 3) * 100, 15 + (i // 3) * 110)
+        arc.set_bg_angles(0, 360)
+        arc.set_value(20 + i * 13)
+        arc.set_style_arc_width(14, lv.PART.MAIN)
+        arc.set_style_arc_width(14, lv.PART.INDICATOR)
+
+
+def gradients(parent):
+    for i in range(4):
+        obj = lv.obj(parent)
+        obj.set_size(145, 100)
+        obj.set_pos(10 + (i % 2) * 155, 15 + (i // 2) * 110)
+        obj.set_style_radius(20, lv.PART.MAIN)
+        obj.set_style_bg_color(lv.color_hex(0xff0000 >> (i * 4)), lv.PART.MAIN)
+        obj.set_style_bg_grad_color(lv.color_hex(0x00ffff), lv.PART.MAIN)
+        obj.set_style_bg_grad_dir(lv.GRAD_DIR.VER if i % 2 else lv.GRAD_DIR.HOR, lv.PART.MAIN)
+
+
+print("draw units: {}".format(lvgl_esp32.DRAW_UNITS))
+
+for name, scene in (("shadows", shadows), ("arcs", arcs), ("gradients", gradients)):
+    screen.clean()
+    scene(screen)
+
+    # Draw the first frame outside of the measurement
+    lv.refr_now(None)
+
+    start = time.ticks_us()
+    for _ in range(FRAMES):
+        screen.invalidate()
+        lv.refr_now(None)
+    elapsed = time.ticks_diff(time.ticks_us(), start)
+
+    print("{:10} {:6} us per frame".format(name + ":", elapsed // FRAMES))
@@ -0,0 +1,10 @@
+# Compares the RGB565 byte-swap implementations, reported in CPU cycles per pixel (nanoseconds on the unix port)
+import lvgl_esp32
+
+for pixels in (16, 320, 320 * 20):
+    for offset in (0, 1):
+        result = lvgl_esp32.benchmark_swap(pixels, iterations=200, offset=offset)
+        print(
+            "{:5} pixels, offset {}: ".format(pixels, offset)
+            + ", ".join("{} {:.2f}".format(name, result[name]) for name in sorted(result))
+        )
@@ -0,0 +1,42 @@
+# Creates a few thousand objects and walks them from Python. The labels inside the list buttons are created by LVGL
+# itself, so the walk is the first time they show up in Python and each of them needs its type looked up.
+import time
+
+from .hardware import display
+
+import lvgl as lv
+import lvgl_esp32
+
+BUTTONS = 2000
+
+wrapper = lvgl_esp32.Wrapper(display)
+wrapper.init()
+
+screen = lv.screen_active()
+lst = lv.list(screen)
+lst.set_size(lv.pct(100), lv.pct(100))
+
+start = time.ticks_us()
+for i in range(BUTTONS):
+    lst.add_button(None, "Item")
+created = time.ticks_diff(time.ticks_us(), start)
+
+
+def walk(parent):
+    count = 0
+    for i in range(parent.get_child_count()):
+        count += 1 + walk(parent.get_child(i))
+    return count
+
+
+start = time.ticks_us()
+first = walk(lst)
+first_us = time.ticks_diff(time.ticks_us(), start)
+
+start = time.ticks_us()
+again = walk(lst)
+again_us = time.ticks_diff(time.ticks_us(), start)
+
+print("create: {} buttons in {} us".format(BUTTONS, created))
+print("walk:   {} objects in {} us, first time".format(first, first_us))
+print("walk:   {} objects in {} us, known".format(again, again_us))
@@ -0,0 +1,28 @@
+# Streams generated RGB565 frames to a part of the screen with blit_async, rendering the next frame while the previous
+# one is being sent
+import time
+
+from .hardware import display
+
+WIDTH = 160
+HEIGHT = 120
+FRAMES = 100
+
+frames = [bytearray(WIDTH * HEIGHT * 2) for _ in range(2)]
+
+start = time.ticks_us()
+for n in range(FRAMES):
+    frame = frames[n % 2]
+
+    # A moving vertical bar, in big-endian RGB565 as the panel expects it
+    x = n % WIDTH
+    frame[:] = b"\x00" * len(frame)
+    for y in range(HEIGHT):
+        offset = (y * WIDTH + x) * 2
+        frame[offset:offset + 2] = b"\xf8\x00"
+
+    display.blit_async(0, 0, WIDTH, HEIGHT, frame)
+
+display.blit_wait()
+elapsed = time.ticks_diff(time.ticks_us(), start)
+print("{} frames of {}x{} in {} us, {:.1f} fps".format(FRAMES, WIDTH, HEIGHT, elapsed, FRAMES * 1_000_000 / elapsed))
@@ -0,0 +1,73 @@
+# Renders a fixed number of frames against the emulated panel of the unix port and reports the throughput, run with
+# LVGL_ESP32_HOST_PCLK_HZ=0 to measure the CPU side only
+import time
+
+import lvgl as lv
+import lvgl_esp32
+
+FRAMES = 200
+
+spi = lvgl_esp32.SPI(2, baudrate=80_000_000, sck=7, mosi=6, miso=8)
+spi.init()
+
+display = lvgl_esp32.Display(
+    spi=spi,
+    width=320,
+    height=240,
+    swap_xy=True,
+    reset=48,
+    dc=4,
+    cs=5,
+    pixel_clock=40_000_000,
+)
+display.init()
+
+# Wrapper arguments of each measured configuration, solid areas of the bounce run go out as fills in between the
+# bounce buffer transfers
+CONFIGS = (
+    ("default", {}),
+    ("bounce + solid_fill", {"memory": lvgl_esp32.Wrapper.MEMORY_SPIRAM_BOUNCE, "solid_fill": True}),
+)
+
+
+def run(name, kwargs):
+    wrapper = lvgl_esp32.Wrapper(display, **kwargs)
+    wrapper.init()
+
+    screen = lv.screen_active()
+    screen.set_style_bg_color(lv.color_hex(0x003a57), lv.PART.MAIN)
+
+    bar = lv.bar(screen)
+    bar.set_size(200, 20)
+    bar.align(lv.ALIGN.CENTER, 0, -40)
+
+    label = lv.label(screen)
+    label.align(lv.ALIGN.CENTER, 0, 20)
+    label.set_style_text_color(lv.color_hex(0xffffff), lv.PART.MAIN)
+
+    # Draw the first frame outside of the measurement
+    lv.refr_now(None)
+    display.reset_bus_stats()
+
+    start = time.ticks_us()
+    for frame in range(FRAMES):
+        bar.set_value(frame % 100, lv.ANIM.OFF)
+        label.set_text("Frame {}".format(frame))
+        lv.refr_now(None)
+    elapsed = time.ticks_diff(time.ticks_us(), start)
+
+    stats = display.bus_stats()
+    print("config:       {}".format(name))
+    print("frames:       {}".format(FRAMES))
+    print("fps:          {:.1f}".format(FRAMES * 1_000_000 / elapsed))
+    print("us per frame: {}".format(elapsed // FRAMES))
+    print("bus busy:     {:.1f}%".format(100 * stats["busy_us"] / elapsed))
+    for key in sorted(stats):
+        print("{:13} {}".format(key + ":", stats[key]))
+    print()
+
+    wrapper.deinit()
+
+
+for name, kwargs in CONFIGS:
+    run(name, kwargs)
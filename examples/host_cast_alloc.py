@@ -0,0 +1,49 @@
+# Checks on the unix port that looking up and casting LVGL objects reuses their Python wrappers, the heap is locked while
+# doing so and any allocation raises a MemoryError
+import micropython
+
+import lvgl as lv
+import lvgl_esp32
+
+ROUNDS = 1000
+
+spi = lvgl_esp32.SPI(2, baudrate=80_000_000, sck=7, mosi=6, miso=8)
+spi.init()
+
+display = lvgl_esp32.Display(
+    spi=spi,
+    width=320,
+    height=240,
+    swap_xy=True,
+    reset=48,
+    dc=4,
+    cs=5,
+    pixel_clock=40_000_000,
+)
+display.init()
+
+wrapper = lvgl_esp32.Wrapper(display)
+wrapper.init()
+
+screen = lv.screen_active()
+label = lv.label(screen)
+
+# The first cast to another type creates the wrapper that is reused afterwards
+as_obj = lv.obj.__cast__(label)
+
+# No range() in the loop, that would allocate too
+micropython.heap_lock()
+try:
+    i = 0
+    while i < ROUNDS:
+        child = screen.get_child(0)
+        same_label = lv.label.__cast__(child)
+        same_obj = lv.obj.__cast__(child)
+        i += 1
+finally:
+    micropython.heap_unlock()
+
+assert child is label
+assert same_label is label
+assert same_obj is as_obj
+print("{} lookups and casts without allocating".format(ROUNDS * 3))
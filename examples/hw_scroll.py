@@ -0,0 +1,27 @@
+# Scrolls a long list with the scroll area of the panel, so only the rows coming in are drawn
+import time
+
+from .hardware import display
+
+import lvgl as lv
+import lvgl_esp32
+
+wrapper = lvgl_esp32.Wrapper(display)
+wrapper.init()
+
+screen = lv.screen_active()
+
+lst = lv.list(screen)
+lst.set_size(lv.pct(100), lv.pct(100))
+lst.set_scrollbar_mode(lv.SCROLLBAR_MODE.OFF)
+for i in range(100):
+    lst.add_button(None, "Line {}".format(i))
+
+wrapper.hw_scroll(lst)
+
+for _ in range(200):
+    lst.scroll_by(0, -4, lv.ANIM.OFF)
+    lv.timer_handler()
+    time.sleep_ms(10)
+
+print(wrapper.stats()["hw_scrolls"])
@@ -0,0 +1,27 @@
+# Hello world on a panel connected through its 8-bit i80 interface, adapt the pins for your own configuration
+import lvgl as lv
+import lvgl_esp32
+
+i80 = lvgl_esp32.I80(data=[8, 9, 10, 11, 12, 13, 14, 15], dc=4, wr=6)
+i80.init()
+
+display = lvgl_esp32.Display(
+    i80=i80,
+    width=320,
+    height=240,
+    swap_xy=True,
+    reset=48,
+    cs=5,
+    pixel_clock=20_000_000,
+)
+display.init()
+
+wrapper = lvgl_esp32.Wrapper(display)
+wrapper.init()
+
+label = lv.label(lv.screen_active())
+label.set_text("Hello world over i80")
+label.align(lv.ALIGN.CENTER, 0, 0)
+
+while True:
+    lv.timer_handler_run_in_period(5)
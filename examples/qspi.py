@@ -0,0 +1,33 @@
+# Hello world on a QSPI panel, adapt the pins for your own configuration
+import lvgl as lv
+import lvgl_esp32
+
+spi = lvgl_esp32.SPI(2, baudrate=40_000_000, sck=47, mosi=18, miso=7, data2=48, data3=5)
+spi.init()
+
+display = lvgl_esp32.Display(
+    spi=spi,
+    qspi=True,
+    width=320,
+    height=240,
+    swap_xy=True,
+    reset=17,
+    cs=6,
+    pixel_clock=40_000_000,
+    # Minimal init sequence, use the one from the vendor of your panel
+    init_cmds=(
+        (0x11, b"", 120),   # SLPOUT
+        (0x3A, b"\x55"),    # COLMOD, RGB565
+    ),
+)
+display.init()
+
+wrapper = lvgl_esp32.Wrapper(display)
+wrapper.init()
+
+label = lv.label(lv.screen_active())
+label.set_text("Hello world over QSPI")
+label.align(lv.ALIGN.CENTER, 0, 0)
+
+while True:
+    lv.timer_handler_run_in_period(5)
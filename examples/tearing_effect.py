@@ -0,0 +1,38 @@
+# Animates a full-screen gradient with flushing paced by the TE pin and reports how frames line up with the refresh
+import time
+
+import lvgl as lv
+import lvgl_esp32
+
+# Adapt these values for your own configuration, TE must be wired to a free GPIO
+spi = lvgl_esp32.SPI(2, baudrate=80_000_000, sck=7, mosi=6, miso=8)
+spi.init()
+
+display = lvgl_esp32.Display(
+    spi=spi,
+    width=320,
+    height=240,
+    swap_xy=True,
+    reset=48,
+    dc=4,
+    cs=5,
+    te=9,
+    pixel_clock=80_000_000,
+)
+display.init()
+
+wrapper = lvgl_esp32.Wrapper(display, render_mode=lvgl_esp32.Wrapper.RENDER_MODE_FULL)
+wrapper.init()
+
+screen = lv.screen_active()
+screen.set_style_bg_grad_dir(lv.GRAD_DIR.HOR, lv.PART.MAIN)
+screen.set_style_bg_grad_color(lv.color_hex(0x000000), lv.PART.MAIN)
+
+start = time.ticks_ms()
+while time.ticks_diff(time.ticks_ms(), start) < 5000:
+    screen.set_style_bg_color(lv.color_hsv_to_rgb(time.ticks_ms() // 10 % 360, 100, 100), lv.PART.MAIN)
+    lv.refr_now(None)
+
+stats = wrapper.frame_stats()
+for key in sorted(stats):
+    print("{:13} {}".format(key + ":", stats[key]))
@@ -5,17 +5,37 @@ add_library(usermod_lvgl_esp32 INTERFACE)
 
 target_sources(usermod_lvgl_esp32 INTERFACE
         ${CMAKE_CURRENT_LIST_DIR}/src/spi.c
+        ${CMAKE_CURRENT_LIST_DIR}/src/i80.c
         ${CMAKE_CURRENT_LIST_DIR}/src/display.c
+        ${CMAKE_CURRENT_LIST_DIR}/src/qspi_io.c
         ${CMAKE_CURRENT_LIST_DIR}/src/wrapper.c
+        ${CMAKE_CURRENT_LIST_DIR}/src/swap.c
+        ${CMAKE_CURRENT_LIST_DIR}/src/trace.c
         ${CMAKE_CURRENT_LIST_DIR}/src/module.c
 )
 
 target_include_directories(usermod_lvgl_esp32 INTERFACE
         ${IDF_PATH}/components/esp_lcd/include/
+        ${IDF_PATH}/components/esp_lcd/interface/
         ${CMAKE_CURRENT_LIST_DIR}/binding/lvgl
         ${CMAKE_CURRENT_LIST_DIR}/binding/lvgl/src
 )
 
+# Lets LVGL run in a render task of its own, see README.md
+if (LVGL_ESP32_USE_OS OR "$ENV{LVGL_ESP32_USE_OS}" STREQUAL "1")
+    target_compile_definitions(usermod_lvgl_esp32 INTERFACE LVGL_ESP32_USE_OS=1)
+endif ()
+
+# Gives LVGL a pool of its own instead of the MicroPython heap, implied by LVGL_ESP32_USE_OS
+if (LVGL_ESP32_MEM_POOL OR "$ENV{LVGL_ESP32_MEM_POOL}" STREQUAL "1")
+    target_compile_definitions(usermod_lvgl_esp32 INTERFACE LVGL_ESP32_MEM_POOL=1)
+endif ()
+
+# Number of software draw units, defaults to 2 with LVGL_ESP32_USE_OS and 1 without
+if (DEFINED ENV{LVGL_ESP32_DRAW_UNITS})
+    target_compile_definitions(usermod_lvgl_esp32 INTERFACE LVGL_ESP32_DRAW_UNITS=$ENV{LVGL_ESP32_DRAW_UNITS})
+endif ()
+
 target_link_libraries(usermod_lvgl_esp32 INTERFACE lvgl_interface)
 
 target_link_libraries(usermod INTERFACE usermod_lvgl_esp32)
@@ -0,0 +1,35 @@
+# Make-based ports (the unix port) pick up this file instead of micropython.cmake. There is no ESP-IDF there, so the
+# esp_lcd and friends are replaced by the host stand-ins in src/host which emulate an ST7789 behind an SPI bus.
+LVGL_ESP32_MOD_DIR := $(USERMOD_DIR)
+
+# Make sure LVGL gets built
+include $(LVGL_ESP32_MOD_DIR)/binding/binding.mk
+
+SRC_USERMOD_C += $(LVGL_ESP32_MOD_DIR)/src/spi.c
+SRC_USERMOD_C += $(LVGL_ESP32_MOD_DIR)/src/i80.c
+SRC_USERMOD_C += $(LVGL_ESP32_MOD_DIR)/src/display.c
+SRC_USERMOD_C += $(LVGL_ESP32_MOD_DIR)/src/qspi_io.c
+SRC_USERMOD_C += $(LVGL_ESP32_MOD_DIR)/src/wrapper.c
+SRC_USERMOD_C += $(LVGL_ESP32_MOD_DIR)/src/swap.c
+SRC_USERMOD_C += $(LVGL_ESP32_MOD_DIR)/src/trace.c
+SRC_USERMOD_C += $(LVGL_ESP32_MOD_DIR)/src/module.c
+SRC_USERMOD_C += $(LVGL_ESP32_MOD_DIR)/src/host/esp_host.c
+SRC_USERMOD_C += $(LVGL_ESP32_MOD_DIR)/src/host/esp_lcd_host.c
+
+# Lets LVGL run in a render task of its own, see README.md
+LVGL_ESP32_USE_OS ?= 0
+
+CFLAGS_USERMOD += -DLVGL_ESP32_HOST=1
+CFLAGS_USERMOD += -DLVGL_ESP32_USE_OS=$(LVGL_ESP32_USE_OS)
+ifdef LVGL_ESP32_MEM_POOL
+CFLAGS_USERMOD += -DLVGL_ESP32_MEM_POOL=$(LVGL_ESP32_MEM_POOL)
+endif
+ifdef LVGL_ESP32_DRAW_UNITS
+CFLAGS_USERMOD += -DLVGL_ESP32_DRAW_UNITS=$(LVGL_ESP32_DRAW_UNITS)
+endif
+CFLAGS_USERMOD += -I$(LVGL_ESP32_MOD_DIR)/src/host/include
+CFLAGS_USERMOD += -I$(LVGL_ESP32_MOD_DIR)/src/host
+CFLAGS_USERMOD += -I$(LVGL_ESP32_MOD_DIR)/binding/lvgl
+CFLAGS_USERMOD += -I$(LVGL_ESP32_MOD_DIR)/binding/lvgl/src
+
+LDFLAGS_USERMOD += -lpthread
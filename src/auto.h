@@ -0,0 +1,7 @@
+#ifndef __LVGL_ESP32_AUTO_H__
+#define __LVGL_ESP32_AUTO_H__
+
+// Value of the bus settings the Wrapper picks from its draw buffers when it is initialized, lvgl_esp32.AUTO in Python
+#define LVGL_ESP32_AUTO (-1)
+
+#endif /* __LVGL_ESP32_AUTO_H__ */
@@ -1,26 +1,67 @@
 #include "display.h"
+#include "auto.h"
+#include "qspi_io.h"
+#include "swap.h"
+#include "trace.h"
 
 #include "py/runtime.h"
 
 #include <stdio.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "esp_timer.h"
+#include "esp_lcd_panel_commands.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_vendor.h"
 #include "esp_lcd_panel_ops.h"
 #include "driver/gpio.h"
 #include "driver/spi_master.h"
+#include "esp_attr.h"
 #include "esp_err.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 
+#if LVGL_ESP32_HOST
+#include "esp_lcd_host.h"
+#endif
+
 static const char *TAG = "lvgl_esp32_display";
 
 // Bit number used to represent command and parameter
 #define LCD_CMD_BITS           8
 #define LCD_PARAM_BITS         8
 
+// QSPI panels take an opcode byte and the command as 24-bit address, see qspi_io.h
+#define QSPI_LCD_CMD_BITS      32
+
+// Upper bound of the fill pattern buffer, which is otherwise as large as the largest transfer the bus accepts
+#define FILL_BUFFER_MAX_SIZE   (16 * 1024)
+
+// Longest a wait for queued transfers blocks before it checks again
+#define TRANS_WAIT_TIMEOUT_MS  20
+
+// Transaction queue depth when not given, and the range AUTO picks from. The transfer tag ring has to be larger.
+#define DEFAULT_QUEUE_DEPTH    10
+#define MIN_QUEUE_DEPTH        2
+#define MAX_QUEUE_DEPTH        (LVGL_ESP32_TRANS_TAG_RING_SIZE - 1)
+
+// Flushes up to this many bytes are polled when not given, a 16x16 icon
+#define DEFAULT_POLL_THRESHOLD 512
+
+// Rows of the frame memory of the ST7789, the vertical scroll definition has to add up to them
+#define GRAM_HEIGHT            320
+
+// Pixel clock when not given, AUTO takes the baudrate of SPI buses
+#define DEFAULT_PIXEL_CLOCK    (20 * 1000 * 1000)
+
+// COLMOD value for 12 bits per pixel, which esp_lcd does not offer
+#define COLMOD_RGB444          0x53
+
+// Marks a rgb565 value that can never be in the fill pattern buffer
+#define FILL_VALUE_NONE        UINT32_MAX
+
 static bool on_color_trans_done_cb(
     esp_lcd_panel_io_handle_t panel_io,
     esp_lcd_panel_io_event_data_t *edata,
@@ -28,13 +69,150 @@ static bool on_color_trans_done_cb(
 )
 {
     lvgl_esp32_Display_obj_t *self = (lvgl_esp32_Display_obj_t *) user_ctx;
+    uint8_t tag = self->trans_tags[self->trans_tag_tail % LVGL_ESP32_TRANS_TAG_RING_SIZE];
+    self->trans_tag_tail++;
+    BaseType_t woken = pdFALSE;
 
-    if (self->transfer_done_cb != NULL)
+    if ((tag & LVGL_ESP32_TRANS_TAG_FILL) && __atomic_fetch_sub(&self->fill_pending, 1, __ATOMIC_RELEASE) == 1)
     {
-        self->transfer_done_cb(self->transfer_done_user_data);
+        xSemaphoreGiveFromISR(self->fill_semaphore, &woken);
+    }
+
+    if (tag & LVGL_ESP32_TRANS_TAG_BLIT)
+    {
+        self->blit_pending = false;
+        xSemaphoreGiveFromISR(self->blit_semaphore, &woken);
+        if (self->blit_callback != mp_const_none)
+        {
+            mp_sched_schedule(self->blit_callback, MP_OBJ_FROM_PTR(self));
+        }
+    }
+
+    if ((tag & LVGL_ESP32_TRANS_TAG_NOTIFY) && self->transfer_done_cb != NULL)
+    {
+        return self->transfer_done_cb(self->transfer_done_user_data) || woken == pdTRUE;
+    }
+
+    return woken == pdTRUE;
+}
+
+// Must be called right before queueing a color transfer, the done callback may run before tx_color returns
+static void push_trans_tag(lvgl_esp32_Display_obj_t *self, uint8_t tag)
+{
+    self->trans_tags[self->trans_tag_head % LVGL_ESP32_TRANS_TAG_RING_SIZE] = tag;
+    self->trans_tag_head++;
+}
+
+// Bytes the given number of pixels takes on the bus
+static size_t bus_bytes(lvgl_esp32_Display_obj_t *self, size_t pixel_count)
+{
+    return self->rgb444 ? (pixel_count * 3 + 1) / 2 : pixel_count * sizeof(uint16_t);
+}
+
+static void IRAM_ATTR te_isr(void *arg)
+{
+    lvgl_esp32_Display_obj_t *self = (lvgl_esp32_Display_obj_t *) arg;
+    int64_t now = esp_timer_get_time();
+
+    if (self->te_count > 0)
+    {
+        self->te_period_us = now - self->te_last_us;
+    }
+    self->te_last_us = now;
+    self->te_count++;
+
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(self->te_semaphore, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+bool lvgl_esp32_Display_wait_te(lvgl_esp32_Display_obj_t *self, uint32_t timeout_ms)
+{
+    if (self->te_semaphore == NULL)
+    {
+        return false;
+    }
+
+    // Forget a pulse that was given while nobody was waiting, only the start of the next refresh counts
+    xSemaphoreTake(self->te_semaphore, 0);
+
+    TickType_t ticks = pdMS_TO_TICKS(timeout_ms);
+    return xSemaphoreTake(self->te_semaphore, ticks > 0 ? ticks : 1) == pdTRUE;
+}
+
+static void set_window(lvgl_esp32_Display_obj_t *self, int x, int y, int width, int height)
+{
+    int x_end = x + width - 1;
+    int y_end = y + height - 1;
+
+    ESP_ERROR_CHECK(
+        esp_lcd_panel_io_tx_param(
+            self->io_handle,
+            LCD_CMD_CASET,
+            (uint8_t[]) { (x >> 8) & 0xFF, x & 0xFF, (x_end >> 8) & 0xFF, x_end & 0xFF },
+            4
+        )
+    );
+    ESP_ERROR_CHECK(
+        esp_lcd_panel_io_tx_param(
+            self->io_handle,
+            LCD_CMD_RASET,
+            (uint8_t[]) { (y >> 8) & 0xFF, y & 0xFF, (y_end >> 8) & 0xFF, y_end & 0xFF },
+            4
+        )
+    );
+}
+
+// Sets up the address window for a memory write of the given rectangle and returns the command to start it with. The
+// rows of the window run to the bottom of the display, so a write of the rows right below in the same columns can
+// continue with RAMWRC instead of sending the addresses again.
+static int begin_write(lvgl_esp32_Display_obj_t *self, int x, int y, int width, int height)
+{
+    int lcd_cmd = LCD_CMD_RAMWR;
+
+    if (self->window_valid && x == self->window_x && width == self->window_width && y == self->window_next_y)
+    {
+        lcd_cmd = LCD_CMD_WRMEMC;
+        self->continued_writes++;
+    }
+    else
+    {
+        set_window(self, x, y, width, self->height - y);
+        self->window_valid = true;
+        self->window_x = x;
+        self->window_width = width;
+    }
+
+    self->window_next_y = y + height;
+
+    return lcd_cmd;
+}
+
+// Rows of the scroll area are shown rotated by scroll_offset, so row y on the screen is stored in another row of the
+// frame memory. Returns how many of the rows starting at y are stored one after the other, from *mem_y on.
+static int map_rows(lvgl_esp32_Display_obj_t *self, int y, int height, int *mem_y)
+{
+    int top = self->scroll_top;
+    int bottom = self->scroll_top + self->scroll_height;
+    int rows = height;
+
+    if (self->scroll_height == 0 || y >= bottom)
+    {
+        *mem_y = y;
+    }
+    else if (y < top)
+    {
+        *mem_y = y;
+        rows = top - y;
+    }
+    else
+    {
+        int row = (y - top + self->scroll_offset) % self->scroll_height;
+        *mem_y = top + row;
+        rows = self->scroll_height - row;
     }
 
-    return false;
+    return rows < height ? rows : height;
 }
 
 void lvgl_esp32_Display_draw_bitmap(
@@ -43,79 +221,537 @@ void lvgl_esp32_Display_draw_bitmap(
     int y_start,
     int x_end,
     int y_end,
-    const void *data
+    const void *data,
+    bool notify
 )
 {
-    ESP_ERROR_CHECK(esp_lcd_panel_draw_bitmap(self->panel, x_start, y_start, x_end, y_end, data));
+    int width = x_end - x_start;
+    uint8_t *pixels = (uint8_t *) data;
+    LVGL_ESP32_TRACE_BEGIN("draw_bitmap");
+
+    // Tiny flushes spend more time in queueing and the interrupt than on the bus. Sent as the parameter of the write they
+    // go out with a polling transaction, which first waits for everything queued before it, so they are done here.
+    bool poll = bus_bytes(self, (size_t) width * (y_end - y_start)) <= self->poll_max;
+
+    for (int y = y_start; y < y_end;)
+    {
+        int mem_y;
+        int rows = map_rows(self, y, y_end - y, &mem_y);
+        size_t count = (size_t) width * rows;
+        size_t size = self->rgb444 ? lvgl_esp32_pack_rgb444(pixels, count) : count * sizeof(uint16_t);
+        int lcd_cmd = begin_write(self, x_start, mem_y, width, rows);
+        y += rows;
+
+        if (poll)
+        {
+            ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(self->io_handle, lcd_cmd, pixels, size));
+        }
+        else
+        {
+            push_trans_tag(self, notify && y == y_end ? LVGL_ESP32_TRANS_TAG_NOTIFY : 0);
+            ESP_ERROR_CHECK(esp_lcd_panel_io_tx_color(self->io_handle, lcd_cmd, pixels, size));
+        }
+        pixels += count * sizeof(uint16_t);
+        self->color_bytes += size;
+        self->color_transactions++;
+    }
+
+    if (!poll)
+    {
+        self->queued_flushes++;
+        LVGL_ESP32_TRACE_END("draw_bitmap");
+        return;
+    }
+
+    self->polled_flushes++;
+    LVGL_ESP32_TRACE_END("draw_bitmap");
+    if (notify && self->transfer_done_cb != NULL)
+    {
+        self->transfer_done_cb(self->transfer_done_user_data);
+    }
+}
+
+void lvgl_esp32_Display_fill_rect(
+    lvgl_esp32_Display_obj_t *self,
+    int x,
+    int y,
+    int width,
+    int height,
+    uint16_t color,
+    bool notify
+)
+{
+    uint16_t value = self->swap_bytes ? __builtin_bswap16(color) : color;
+
+    if (value != self->fill_value)
+    {
+        // Earlier fills may still be reading the pattern. A give left over from an earlier wait only costs another
+        // check of the counter.
+        while (__atomic_load_n(&self->fill_pending, __ATOMIC_ACQUIRE) > 0)
+        {
+            xSemaphoreTake(self->fill_semaphore, pdMS_TO_TICKS(TRANS_WAIT_TIMEOUT_MS));
+        }
+
+        if (self->rgb444)
+        {
+            // The pattern repeats every pair of pixels, in three bytes
+            uint8_t pair[6] = { 0 };
+            uint16_t pixels[2] = { value, value };
+            memcpy(pair, pixels, sizeof(pixels));
+            lvgl_esp32_pack_rgb444(pair, 2);
+
+            uint8_t *bytes = (uint8_t *) self->fill_buf;
+            for (size_t i = 0; i < self->fill_buf_size; i += 3)
+            {
+                memcpy(&bytes[i], pair, 3);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < self->fill_buf_size / sizeof(uint16_t); i++)
+            {
+                self->fill_buf[i] = value;
+            }
+        }
+        self->fill_value = value;
+    }
+
+    for (int y_end = y + height; y < y_end;)
+    {
+        int mem_y;
+        int rows = map_rows(self, y, y_end - y, &mem_y);
+        y += rows;
+
+        // The first transaction starts writing at the top left of the rows, the next ones continue where it stopped
+        size_t remaining = bus_bytes(self, (size_t) width * rows);
+        int lcd_cmd = begin_write(self, x, mem_y, width, rows);
+
+        while (remaining > 0)
+        {
+            size_t chunk = remaining < self->fill_buf_size ? remaining : self->fill_buf_size;
+            remaining -= chunk;
+
+            bool last = y == y_end && remaining == 0;
+            __atomic_fetch_add(&self->fill_pending, 1, __ATOMIC_RELAXED);
+            push_trans_tag(self, LVGL_ESP32_TRANS_TAG_FILL | (notify && last ? LVGL_ESP32_TRANS_TAG_NOTIFY : 0));
+            ESP_ERROR_CHECK(esp_lcd_panel_io_tx_color(self->io_handle, lcd_cmd, self->fill_buf, chunk));
+            self->color_bytes += chunk;
+            self->color_transactions++;
+
+            lcd_cmd = LCD_CMD_WRMEMC;
+        }
+    }
+}
+
+static void send_scroll_start(lvgl_esp32_Display_obj_t *self)
+{
+    int start = self->scroll_top + self->scroll_offset;
+
+    ESP_ERROR_CHECK(
+        esp_lcd_panel_io_tx_param(self->io_handle, LCD_CMD_VSCSAD, (uint8_t[]) { (start >> 8) & 0xFF, start & 0xFF }, 2)
+    );
+}
+
+void lvgl_esp32_Display_set_scroll_area(lvgl_esp32_Display_obj_t *self, int top, int height)
+{
+    // Without a scroll area the definition covers the whole frame memory, scrolled by nothing
+    int tfa = height > 0 ? top : 0;
+    int vsa = height > 0 ? height : GRAM_HEIGHT;
+    int bfa = GRAM_HEIGHT - tfa - vsa;
+
+    ESP_ERROR_CHECK(
+        esp_lcd_panel_io_tx_param(
+            self->io_handle,
+            LCD_CMD_VSCRDEF,
+            (uint8_t[]) {
+                (tfa >> 8) & 0xFF, tfa & 0xFF, (vsa >> 8) & 0xFF, vsa & 0xFF, (bfa >> 8) & 0xFF, bfa & 0xFF
+            },
+            6
+        )
+    );
+
+    self->scroll_top = tfa;
+    self->scroll_height = height > 0 ? height : 0;
+    self->scroll_offset = 0;
+    send_scroll_start(self);
+
+    self->window_valid = false;
+    self->foreign_writes++;
+}
+
+void lvgl_esp32_Display_scroll(lvgl_esp32_Display_obj_t *self, int dy)
+{
+    if (self->scroll_height == 0)
+    {
+        return;
+    }
+
+    int offset = (self->scroll_offset + dy) % self->scroll_height;
+    self->scroll_offset = offset < 0 ? offset + self->scroll_height : offset;
+    send_scroll_start(self);
+
+    self->window_valid = false;
+    self->foreign_writes++;
+}
+
+void lvgl_esp32_Display_set_rotation(lvgl_esp32_Display_obj_t *self, uint8_t rotation)
+{
+    // A quarter turn clockwise is MV with MY, as the mirroring comes before the exchange of rows and columns. Turned,
+    // the mirror bits of the constructor apply to the other axis.
+    bool turn_xy = rotation & 1;
+    bool turn_x = rotation == 2 || rotation == 3;
+    bool turn_y = rotation == 1 || rotation == 2;
+
+    if (((self->rotation ^ rotation) & 1) != 0)
+    {
+        uint16_t width = self->width;
+        self->width = self->height;
+        self->height = width;
+    }
+
+    self->rotation = rotation;
+    self->foreign_writes++;
+    self->swap_xy = self->base_swap_xy ^ turn_xy;
+    self->mirror_x = (turn_xy ? self->base_mirror_y : self->base_mirror_x) ^ turn_x;
+    self->mirror_y = (turn_xy ? self->base_mirror_x : self->base_mirror_y) ^ turn_y;
+
+    if (self->panel != NULL)
+    {
+        // The rows of a scroll area would run along the other axis
+        if (self->scroll_height > 0)
+        {
+            lvgl_esp32_Display_set_scroll_area(self, 0, 0);
+        }
+
+        ESP_ERROR_CHECK(esp_lcd_panel_swap_xy(self->panel, self->swap_xy));
+        ESP_ERROR_CHECK(esp_lcd_panel_mirror(self->panel, self->mirror_x, self->mirror_y));
+        self->window_valid = false;
+    }
+
+    if (self->rotation_cb != NULL)
+    {
+        self->rotation_cb(self->rotation_user_data);
+    }
+}
+
+uint64_t lvgl_esp32_Display_bus_time_us(lvgl_esp32_Display_obj_t *self, uint64_t bytes)
+{
+    int bits_per_clock = self->i80 != NULL ? self->i80->bus_width : (self->qspi ? 4 : 1);
+
+    return bytes * 8 * 1000000 / ((uint64_t) self->pixel_clock * bits_per_clock);
+}
+
+static size_t bus_max_transfer(lvgl_esp32_Display_obj_t *self)
+{
+    size_t max_transfer = 0;
+    if (self->i80 != NULL)
+    {
+        max_transfer = self->i80->max_transfer_bytes;
+    }
+    else
+    {
+        ESP_ERROR_CHECK(spi_bus_get_max_transaction_len(self->spi->spi_host_device, &max_transfer));
+    }
+
+    return max_transfer;
+}
+
+static void fill_init(lvgl_esp32_Display_obj_t *self)
+{
+    size_t max_transfer = bus_max_transfer(self);
+
+    size_t frame_size = (size_t) self->width * self->height * sizeof(uint16_t);
+    size_t size = max_transfer < FILL_BUFFER_MAX_SIZE ? max_transfer : FILL_BUFFER_MAX_SIZE;
+    size = (size < frame_size ? size : frame_size) & ~(sizeof(uint16_t) - 1);
+
+    // RGB444 chunks have to end between two pairs of pixels
+    if (self->rgb444)
+    {
+        size -= size % 6;
+    }
+
+    ESP_LOGI(TAG, "Creating fill buffer of %zu bytes", size);
+    self->fill_buf = heap_caps_malloc(size, MALLOC_CAP_DMA);
+    if (self->fill_buf == NULL)
+    {
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Could not allocate fill buffer"));
+    }
+
+    self->fill_semaphore = xSemaphoreCreateBinary();
+    if (self->fill_semaphore == NULL)
+    {
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Could not create fill semaphore"));
+    }
+
+    self->fill_buf_size = size;
+    self->fill_value = FILL_VALUE_NONE;
+    self->fill_pending = 0;
 }
 
 static void clear(lvgl_esp32_Display_obj_t *self)
 {
     ESP_LOGI(TAG, "Clearing screen");
 
-    // Create a temporary empty buffer of only one line of pixels so this will also work on memory-constrained devices
-    size_t buf_size = self->width;
-    uint16_t *buf = heap_caps_calloc(1, buf_size * sizeof(uint16_t), MALLOC_CAP_DMA);
+    lvgl_esp32_Display_fill_rect(self, 0, 0, self->width, self->height, 0x0000, false);
+    self->foreign_writes++;
+}
 
-    assert(buf);
+static void te_init(lvgl_esp32_Display_obj_t *self)
+{
+    ESP_LOGI(TAG, "Setting up TE on pin %d", self->te);
 
-    // Blit lines to the screen
-    for (int line = 0; line < self->height; line++)
+    self->te_semaphore = xSemaphoreCreateBinary();
+    if (self->te_semaphore == NULL)
     {
-        lvgl_esp32_Display_draw_bitmap(self, 0, line, self->width, line + 1, buf);
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Could not create TE semaphore"));
     }
 
-    // Release the buffer
-    heap_caps_free(buf);
+    self->te_count = 0;
+    self->te_last_us = 0;
+    self->te_period_us = 0;
+
+    gpio_config_t te_config = {
+        .pin_bit_mask = 1ULL << self->te,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_POSEDGE,
+    };
+    ESP_ERROR_CHECK(gpio_config(&te_config));
+
+    // The ISR service is shared with machine.Pin, which may have installed it already
+    esp_err_t ret = gpio_install_isr_service(0);
+    if (ret != ESP_ERR_INVALID_STATE)
+    {
+        ESP_ERROR_CHECK(ret);
+    }
+    ESP_ERROR_CHECK(gpio_isr_handler_add(self->te, te_isr, self));
+
+    // Pulse during the vertical blanking period only
+    uint8_t te_mode = 0;
+    ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(self->io_handle, LCD_CMD_TEON, &te_mode, 1));
 }
 
-static mp_obj_t lvgl_esp32_Display_init(mp_obj_t self_ptr)
+static void te_deinit(lvgl_esp32_Display_obj_t *self)
 {
-    lvgl_esp32_Display_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+    ESP_LOGI(TAG, "Releasing TE pin %d", self->te);
+
+    ESP_ERROR_CHECK(gpio_isr_handler_remove(self->te));
+    ESP_ERROR_CHECK(gpio_reset_pin(self->te));
+
+    vSemaphoreDelete(self->te_semaphore);
+    self->te_semaphore = NULL;
+}
+
+static void blit_wait(lvgl_esp32_Display_obj_t *self)
+{
+    // A give left over from an earlier blit only costs another check of the flag. Scheduled callbacks and Ctrl-C are
+    // handled in between.
+    while (self->blit_pending)
+    {
+        xSemaphoreTake(self->blit_semaphore, pdMS_TO_TICKS(TRANS_WAIT_TIMEOUT_MS));
+        mp_handle_pending(true);
+    }
 
-    ESP_LOGI(TAG, "Setting up panel IO");
+    self->blit_buf = mp_const_none;
+}
+
+static void panel_io_init_spi(lvgl_esp32_Display_obj_t *self)
+{
+    ESP_LOGI(TAG, "Setting up %s panel IO", self->qspi ? "QSPI" : "SPI");
     esp_lcd_panel_io_spi_config_t io_config = {
-        .dc_gpio_num = self->dc,
+        .dc_gpio_num = self->qspi ? -1 : self->dc,
         .cs_gpio_num = self->cs,
         .pclk_hz = self->pixel_clock,
-        .lcd_cmd_bits = LCD_CMD_BITS,
+        .lcd_cmd_bits = self->qspi ? QSPI_LCD_CMD_BITS : LCD_CMD_BITS,
         .lcd_param_bits = LCD_PARAM_BITS,
         .spi_mode = 0,
-        .trans_queue_depth = 10,
+        .trans_queue_depth = self->queue_depth,
         .on_color_trans_done = on_color_trans_done_cb,
         .user_ctx = self,
+        .flags = {
+            .quad_mode = self->qspi,
+        },
     };
 
     ESP_ERROR_CHECK(
         esp_lcd_new_panel_io_spi(
             (esp_lcd_spi_bus_handle_t) self->spi->spi_host_device,
             &io_config,
-            &self->io_handle
+            &self->bus_io
         )
     );
 
+    if (self->qspi)
+    {
+        // Deleting the framing panel IO deletes bus_io too
+        ESP_ERROR_CHECK(lvgl_esp32_new_qspi_panel_io(self->bus_io, &self->io_handle));
+    }
+    else
+    {
+        self->io_handle = self->bus_io;
+    }
+
     // HACK
     self->spi->device_count++;
+}
+
+static void panel_io_init_i80(lvgl_esp32_Display_obj_t *self)
+{
+    ESP_LOGI(TAG, "Setting up i80 panel IO");
+    esp_lcd_panel_io_i80_config_t io_config = {
+        .cs_gpio_num = self->cs,
+        .pclk_hz = self->pixel_clock,
+        .trans_queue_depth = self->queue_depth,
+        .on_color_trans_done = on_color_trans_done_cb,
+        .user_ctx = self,
+        .lcd_cmd_bits = LCD_CMD_BITS,
+        .lcd_param_bits = LCD_PARAM_BITS,
+        .dc_levels = {
+            .dc_idle_level = 0,
+            .dc_cmd_level = 0,
+            .dc_dummy_level = 0,
+            .dc_data_level = 1,
+        },
+        .flags = {
+            // The peripheral swaps the bytes of LVGL's RGB565 for free
+            .swap_color_bytes = !self->little_endian,
+        },
+    };
+
+    ESP_ERROR_CHECK(esp_lcd_new_panel_io_i80(self->i80->bus_handle, &io_config, &self->bus_io));
+    self->io_handle = self->bus_io;
+
+    // HACK
+    self->i80->device_count++;
+}
+
+static void panel_io_init(lvgl_esp32_Display_obj_t *self)
+{
+    if (self->i80 != NULL)
+    {
+        panel_io_init_i80(self);
+    }
+    else
+    {
+        panel_io_init_spi(self);
+    }
+
+    // Parameters are not split into several transactions like colors. i80 buses only swap the bytes of colors, QSPI
+    // panels take parameters on a single line.
+    self->poll_max = 0;
+    if (self->spi != NULL && !self->qspi)
+    {
+        size_t max_transfer = bus_max_transfer(self);
+        self->poll_max = self->poll_threshold < max_transfer ? self->poll_threshold : max_transfer;
+    }
+
+    // Only memory writes may come between a write and the RAMWRC continuing it
+    self->window_valid = false;
+}
+
+// Sends the init sequence given for a controller other than the ST7789, checked by make_new already
+static void send_init_cmds(lvgl_esp32_Display_obj_t *self)
+{
+    size_t count;
+    mp_obj_t *cmds;
+    mp_obj_get_array(self->init_cmds, &count, &cmds);
+
+    ESP_LOGI(TAG, "Sending %zu init commands", count);
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t len;
+        mp_obj_t *cmd;
+        mp_obj_get_array(cmds[i], &len, &cmd);
 
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(cmd[1], &bufinfo, MP_BUFFER_READ);
+
+        ESP_ERROR_CHECK(
+            esp_lcd_panel_io_tx_param(
+                self->io_handle,
+                mp_obj_get_int(cmd[0]),
+                bufinfo.len > 0 ? bufinfo.buf : NULL,
+                bufinfo.len
+            )
+        );
+
+        if (len == 3)
+        {
+            vTaskDelay(pdMS_TO_TICKS(mp_obj_get_int(cmd[2])));
+        }
+    }
+}
+
+static void panel_new(lvgl_esp32_Display_obj_t *self, int reset_gpio_num)
+{
     ESP_LOGI(TAG, "Setting up ST7789 panel driver");
     esp_lcd_panel_dev_config_t panel_config = {
-        .reset_gpio_num = self->reset,
+        .reset_gpio_num = reset_gpio_num,
         .rgb_ele_order = self->bgr ? LCD_RGB_ELEMENT_ORDER_BGR : LCD_RGB_ELEMENT_ORDER_RGB,
         .bits_per_pixel = 16,
+        .data_endian = self->little_endian ? LCD_RGB_DATA_ENDIAN_LITTLE : LCD_RGB_DATA_ENDIAN_BIG,
     };
 
     ESP_ERROR_CHECK(esp_lcd_new_panel_st7789(self->io_handle, &panel_config, &self->panel));
+}
+
+static mp_obj_t lvgl_esp32_Display_init(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Display_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    panel_io_init(self);
+    fill_init(self);
+
+    self->blit_semaphore = xSemaphoreCreateBinary();
+    if (self->blit_semaphore == NULL)
+    {
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Could not create blit semaphore"));
+    }
+
+    self->polled_flushes = 0;
+    self->queued_flushes = 0;
+
+    panel_new(self, self->reset);
     ESP_ERROR_CHECK(esp_lcd_panel_reset(self->panel));
-    ESP_ERROR_CHECK(esp_lcd_panel_init(self->panel));
+    if (self->init_cmds != mp_const_none)
+    {
+        send_init_cmds(self);
+    }
+    else
+    {
+        ESP_ERROR_CHECK(esp_lcd_panel_init(self->panel));
+    }
+
+    if (self->rgb444)
+    {
+        ESP_ERROR_CHECK(
+            esp_lcd_panel_io_tx_param(self->io_handle, LCD_CMD_COLMOD, (uint8_t[]) { COLMOD_RGB444 }, 1)
+        );
+    }
 
     ESP_ERROR_CHECK(esp_lcd_panel_invert_color(self->panel, self->invert));
     ESP_ERROR_CHECK(esp_lcd_panel_swap_xy(self->panel, self->swap_xy));
 	ESP_ERROR_CHECK(esp_lcd_panel_mirror(self->panel, self->mirror_x, self->mirror_y));
 
+    // The reset left the panel without a scroll area
+    self->scroll_top = 0;
+    self->scroll_height = 0;
+    self->scroll_offset = 0;
+
+    self->window_valid = false;
     clear(self);
 
     ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(self->panel, true));
 
+    if (self->te >= 0)
+    {
+        te_init(self);
+    }
+
+    // Only memory writes may come between a write and the RAMWRC continuing it
+    self->window_valid = false;
+
     return mp_obj_new_int_from_uint(0);
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Display_init_obj, lvgl_esp32_Display_init);
@@ -124,6 +760,11 @@ static mp_obj_t lvgl_esp32_Display_deinit(mp_obj_t self_ptr)
 {
     lvgl_esp32_Display_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
 
+    if (self->te_semaphore != NULL)
+    {
+        te_deinit(self);
+    }
+
     if(self->panel != NULL)
     {
         ESP_LOGI(TAG, "Deinitializing ST7789 panel driver");
@@ -137,17 +778,469 @@ static mp_obj_t lvgl_esp32_Display_deinit(mp_obj_t self_ptr)
         ESP_LOGI(TAG, "Deinitializing panel IO");
         ESP_ERROR_CHECK(esp_lcd_panel_io_del(self->io_handle));
         self->io_handle = NULL;
+        self->bus_io = NULL;
+
+        heap_caps_free(self->fill_buf);
+        self->fill_buf = NULL;
+        if (self->fill_semaphore != NULL)
+        {
+            vSemaphoreDelete(self->fill_semaphore);
+            self->fill_semaphore = NULL;
+        }
+
+        // Deleting the panel IO waited for all transfers, including a blit that was still in flight
+        self->blit_pending = false;
+        if (self->blit_semaphore != NULL)
+        {
+            vSemaphoreDelete(self->blit_semaphore);
+            self->blit_semaphore = NULL;
+        }
+        self->blit_buf = mp_const_none;
+        self->blit_callback = mp_const_none;
 
         // HACK
+        // We call deinit on the bus in case it was (unsuccessfully) deleted earlier
+        if (self->i80 != NULL)
+        {
+            self->i80->device_count--;
+            lvgl_esp32_I80_internal_deinit(self->i80);
+        }
+        else
+        {
+            self->spi->device_count--;
+            lvgl_esp32_SPI_internal_deinit(self->spi);
+        }
+    }
+
+    return mp_obj_new_int_from_uint(0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Display_deinit_obj, lvgl_esp32_Display_deinit);
+
+// Deletes the panel IO and the panel driver bound to it, once the transfers in flight are done. Deleting the driver
+// sends nothing to the panel.
+static void panel_io_detach(lvgl_esp32_Display_obj_t *self)
+{
+    blit_wait(self);
+
+    ESP_LOGI(TAG, "Deinitializing panel IO for the bus plan");
+    ESP_ERROR_CHECK(esp_lcd_panel_del(self->panel));
+    self->panel = NULL;
+    ESP_ERROR_CHECK(esp_lcd_panel_io_del(self->io_handle));
+    self->io_handle = NULL;
+    self->bus_io = NULL;
+
+    // HACK
+    if (self->i80 != NULL)
+    {
+        self->i80->device_count--;
+    }
+    else
+    {
         self->spi->device_count--;
+    }
+}
+
+// Creates the panel IO and driver again without resetting or initializing the panel, which keeps its setup and what it
+// shows. The driver only needs to learn the orientation, it composes MADCTL from it.
+static void panel_io_attach(lvgl_esp32_Display_obj_t *self)
+{
+    panel_io_init(self);
+    panel_new(self, -1);
+
+    ESP_ERROR_CHECK(esp_lcd_panel_swap_xy(self->panel, self->swap_xy));
+    ESP_ERROR_CHECK(esp_lcd_panel_mirror(self->panel, self->mirror_x, self->mirror_y));
+    self->window_valid = false;
+}
+
+// Room for every transaction of the flushes in flight, plus the one being set up
+static uint8_t plan_queue_depth(size_t flush_size, size_t max_transfer, uint8_t flushes_in_flight)
+{
+    size_t depth = (flush_size + max_transfer - 1) / max_transfer * flushes_in_flight + 1;
+    return depth < MIN_QUEUE_DEPTH ? MIN_QUEUE_DEPTH : (depth > MAX_QUEUE_DEPTH ? MAX_QUEUE_DEPTH : depth);
+}
+
+void lvgl_esp32_Display_plan_bus(lvgl_esp32_Display_obj_t *self, size_t flush_size, uint8_t flushes_in_flight)
+{
+    bool auto_transfer = self->i80 != NULL ? self->i80->auto_transfer : self->spi->auto_transfer;
+    if (!auto_transfer && !self->auto_queue_depth)
+    {
+        return;
+    }
+
+    // One flush should be one transaction, as far as the peripheral allows
+    size_t bus_transfer = self->i80 != NULL ? self->i80->max_transfer_bytes : self->spi->max_transfer_bytes;
+    size_t max_transfer = bus_transfer;
+    if (auto_transfer)
+    {
+        max_transfer = flush_size;
+        if (self->spi != NULL && max_transfer > LVGL_ESP32_SPI_MAX_TRANSFER_BYTES)
+        {
+            max_transfer = LVGL_ESP32_SPI_MAX_TRANSFER_BYTES;
+        }
+    }
+    else if (max_transfer == 0)
+    {
+        ESP_ERROR_CHECK(spi_bus_get_max_transaction_len(self->spi->spi_host_device, &max_transfer));
+    }
+
+    bool transfer_changed = auto_transfer && max_transfer != bus_transfer;
+    uint8_t queue_depth = self->auto_queue_depth
+        ? plan_queue_depth(flush_size, max_transfer, flushes_in_flight)
+        : self->queue_depth;
+
+    // The panel IO is created with both, an initialized display only gets a new one when the plan differs
+    bool attached = self->io_handle != NULL && (transfer_changed || queue_depth != self->queue_depth);
+    if (attached)
+    {
+        panel_io_detach(self);
+    }
+
+    if (transfer_changed)
+    {
+        bool applied = self->i80 != NULL
+            ? lvgl_esp32_I80_set_max_transfer_bytes(self->i80, max_transfer)
+            : lvgl_esp32_SPI_set_max_transfer_bytes(self->spi, max_transfer);
+
+        // Other devices on the bus keep it as it is, plan with the transfer size it has
+        if (!applied)
+        {
+            ESP_LOGW(TAG, "Planning with the current transfer size of the bus");
+            max_transfer = bus_transfer;
+            if (self->spi != NULL && max_transfer == 0)
+            {
+                ESP_ERROR_CHECK(spi_bus_get_max_transaction_len(self->spi->spi_host_device, &max_transfer));
+            }
+
+            if (self->auto_queue_depth)
+            {
+                queue_depth = plan_queue_depth(flush_size, max_transfer, flushes_in_flight);
+            }
+        }
+    }
+    self->queue_depth = queue_depth;
+
+    uint64_t flush_us = lvgl_esp32_Display_bus_time_us(self, flush_size);
+    ESP_LOGI(
+        TAG,
+        "Bus plan: %zu byte flushes in %zu byte transactions, queue depth %d, %llu us per flush at %lu Hz",
+        flush_size,
+        max_transfer,
+        queue_depth,
+        (unsigned long long) flush_us,
+        (unsigned long) self->pixel_clock
+    );
+
+    if (attached)
+    {
+        panel_io_attach(self);
+    }
+}
+
+static void render_lock(lvgl_esp32_Display_obj_t *self)
+{
+    if (self->lock_cb != NULL)
+    {
+        self->lock_cb(self->lock_user_data);
+    }
+}
+
+static void render_unlock(lvgl_esp32_Display_obj_t *self)
+{
+    if (self->unlock_cb != NULL)
+    {
+        self->unlock_cb(self->lock_user_data);
+    }
+}
+
+// Fills a rectangle with a color given as 0xRRGGBB
+static mp_obj_t lvgl_esp32_Display_fill_rect_py(size_t n_args, const mp_obj_t *args)
+{
+    lvgl_esp32_Display_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t x = mp_obj_get_int(args[1]);
+    mp_int_t y = mp_obj_get_int(args[2]);
+    mp_int_t width = mp_obj_get_int(args[3]);
+    mp_int_t height = mp_obj_get_int(args[4]);
+    uint32_t rgb = mp_obj_get_int_truncated(args[5]);
 
-        // We call deinit on spi in case it was (unsuccessfully) deleted earlier
-        lvgl_esp32_SPI_internal_deinit(self->spi);
+    if (self->io_handle == NULL)
+    {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Display is not initialized"));
+    }
+
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 || x + width > self->width || y + height > self->height)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Rectangle outside of the display"));
     }
 
+    uint16_t color = ((rgb >> 8) & 0xF800) | ((rgb >> 5) & 0x07E0) | ((rgb >> 3) & 0x001F);
+    render_lock(self);
+    lvgl_esp32_Display_fill_rect(self, x, y, width, height, color, false);
+    self->foreign_writes++;
+    render_unlock(self);
+
     return mp_obj_new_int_from_uint(0);
 }
-static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Display_deinit_obj, lvgl_esp32_Display_deinit);
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(lvgl_esp32_Display_fill_rect_obj, 6, 6, lvgl_esp32_Display_fill_rect_py);
+
+// Defines the rows that scroll in hardware, a height of 0 removes the scroll area
+static mp_obj_t lvgl_esp32_Display_set_scroll_area_py(mp_obj_t self_ptr, mp_obj_t top_obj, mp_obj_t height_obj)
+{
+    lvgl_esp32_Display_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+    mp_int_t top = mp_obj_get_int(top_obj);
+    mp_int_t height = mp_obj_get_int(height_obj);
+
+    if (self->io_handle == NULL)
+    {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Display is not initialized"));
+    }
+
+    if (self->swap_xy || self->mirror_y)
+    {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Hardware scrolling needs swap_xy and mirror_y off"));
+    }
+
+    if (top < 0 || height < 0 || top + height > self->height)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Scroll area outside of the display"));
+    }
+
+    render_lock(self);
+    lvgl_esp32_Display_set_scroll_area(self, top, height);
+    render_unlock(self);
+
+    return mp_obj_new_int_from_uint(0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_3(lvgl_esp32_Display_set_scroll_area_obj, lvgl_esp32_Display_set_scroll_area_py);
+
+// Moves the contents of the scroll area up by dy rows, the rows that wrap around have to be drawn again
+static mp_obj_t lvgl_esp32_Display_scroll_py(mp_obj_t self_ptr, mp_obj_t dy_obj)
+{
+    lvgl_esp32_Display_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+    mp_int_t dy = mp_obj_get_int(dy_obj);
+
+    if (self->io_handle == NULL || self->scroll_height == 0)
+    {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("No scroll area"));
+    }
+
+    render_lock(self);
+    lvgl_esp32_Display_scroll(self, dy);
+    render_unlock(self);
+
+    return mp_obj_new_int_from_uint(0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(lvgl_esp32_Display_scroll_obj, lvgl_esp32_Display_scroll_py);
+
+// Turns the display clockwise by 0, 90, 180 or 270 degrees from the orientation given to the constructor
+static mp_obj_t lvgl_esp32_Display_set_rotation_py(mp_obj_t self_ptr, mp_obj_t degrees_obj)
+{
+    lvgl_esp32_Display_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+    mp_int_t degrees = mp_obj_get_int(degrees_obj);
+
+    if (degrees % 90 != 0)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Rotation must be a multiple of 90 degrees"));
+    }
+
+    render_lock(self);
+    lvgl_esp32_Display_set_rotation(self, ((degrees / 90) % 4 + 4) % 4);
+    render_unlock(self);
+
+    return mp_obj_new_int_from_uint(0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(lvgl_esp32_Display_set_rotation_obj, lvgl_esp32_Display_set_rotation_py);
+
+// Sends RGB565 pixels straight from a Python buffer. Buffers in internal RAM are sent by DMA without a copy, others
+// are copied by the SPI driver. Only one blit is in flight at a time, a new one waits for the previous.
+// Pixels go out in the order the bus takes colors: SPI panels take big-endian ones, i80 buses swap colors themselves
+// and little_endian panels take them as they are, so both take native little-endian ones.
+static mp_obj_t blit(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args, bool async)
+{
+    enum
+    {
+        ARG_x,              // left edge of the rectangle
+        ARG_y,              // top edge of the rectangle
+        ARG_w,              // width of the rectangle
+        ARG_h,              // height of the rectangle
+        ARG_buf,            // object with the buffer protocol holding w * h RGB565 pixels
+        ARG_swap,           // byte-swap the pixels in place first, for buffers in the other byte order
+        ARG_callback,       // called with the display once an async blit is done
+    };
+
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_x, MP_ARG_INT | MP_ARG_REQUIRED },
+        { MP_QSTR_y, MP_ARG_INT | MP_ARG_REQUIRED },
+        { MP_QSTR_w, MP_ARG_INT | MP_ARG_REQUIRED },
+        { MP_QSTR_h, MP_ARG_INT | MP_ARG_REQUIRED },
+        { MP_QSTR_buf, MP_ARG_OBJ | MP_ARG_REQUIRED },
+        { MP_QSTR_swap, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false }},
+        { MP_QSTR_callback, MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none }},
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    lvgl_esp32_Display_obj_t *self = MP_OBJ_TO_PTR(pos_args[0]);
+    mp_int_t x = args[ARG_x].u_int;
+    mp_int_t y = args[ARG_y].u_int;
+    mp_int_t width = args[ARG_w].u_int;
+    mp_int_t height = args[ARG_h].u_int;
+
+    if (self->io_handle == NULL)
+    {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Display is not initialized"));
+    }
+
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 || x + width > self->width || y + height > self->height)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Rectangle outside of the display"));
+    }
+
+    if (args[ARG_callback].u_obj != mp_const_none && !mp_obj_is_callable(args[ARG_callback].u_obj))
+    {
+        mp_raise_TypeError(MP_ERROR_TEXT("Callback is not callable"));
+    }
+
+    // Packed RGB444 rows only start on a byte when the width is even
+    if (self->rgb444 && (args[ARG_swap].u_bool || (width & 1)))
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("RGB444 blits need an even width and no swap"));
+    }
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[ARG_buf].u_obj, &bufinfo, args[ARG_swap].u_bool ? MP_BUFFER_RW : MP_BUFFER_READ);
+
+    size_t pixels = (size_t) width * height;
+    if (bufinfo.len < bus_bytes(self, pixels))
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Buffer too small"));
+    }
+
+    blit_wait(self);
+
+    if (args[ARG_swap].u_bool)
+    {
+        lvgl_esp32_swap_rgb565(bufinfo.buf, pixels);
+    }
+
+    render_lock(self);
+    self->blit_buf = args[ARG_buf].u_obj;
+    self->blit_callback = async ? args[ARG_callback].u_obj : mp_const_none;
+    self->blit_pending = true;
+    self->foreign_writes++;
+
+    const uint8_t *data = bufinfo.buf;
+    for (int row = y; row < y + height;)
+    {
+        int mem_y;
+        int rows = map_rows(self, row, y + height - row, &mem_y);
+        size_t size = bus_bytes(self, (size_t) width * rows);
+        int lcd_cmd = begin_write(self, x, mem_y, width, rows);
+        row += rows;
+
+        push_trans_tag(self, row == y + height ? LVGL_ESP32_TRANS_TAG_BLIT : 0);
+        ESP_ERROR_CHECK(esp_lcd_panel_io_tx_color(self->io_handle, lcd_cmd, data, size));
+        data += size;
+        self->color_bytes += size;
+        self->color_transactions++;
+    }
+    render_unlock(self);
+
+    if (!async)
+    {
+        blit_wait(self);
+    }
+
+    return mp_obj_new_int_from_uint(0);
+}
+
+static mp_obj_t lvgl_esp32_Display_blit(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    return blit(n_args, pos_args, kw_args, false);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(lvgl_esp32_Display_blit_obj, 6, lvgl_esp32_Display_blit);
+
+static mp_obj_t lvgl_esp32_Display_blit_async(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    return blit(n_args, pos_args, kw_args, true);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(lvgl_esp32_Display_blit_async_obj, 6, lvgl_esp32_Display_blit_async);
+
+static mp_obj_t lvgl_esp32_Display_blit_busy(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Display_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    return mp_obj_new_bool(self->blit_pending);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Display_blit_busy_obj, lvgl_esp32_Display_blit_busy);
+
+static mp_obj_t lvgl_esp32_Display_blit_wait(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Display_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    blit_wait(self);
+
+    return mp_obj_new_int_from_uint(0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Display_blit_wait_obj, lvgl_esp32_Display_blit_wait);
+
+#if LVGL_ESP32_HOST
+// Returns the image currently shown by the emulated panel as native RGB565 values, in the panel's own orientation
+static mp_obj_t lvgl_esp32_Display_framebuffer(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Display_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    if (self->io_handle == NULL)
+    {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Display is not initialized"));
+    }
+
+    size_t len = ESP_LCD_HOST_GRAM_WIDTH * ESP_LCD_HOST_GRAM_HEIGHT * sizeof(uint16_t);
+    uint16_t *pixels = m_malloc(len);
+    ESP_ERROR_CHECK(esp_lcd_host_panel_io_snapshot(self->bus_io, pixels));
+
+    mp_obj_t result = mp_obj_new_bytes((const byte *) pixels, len);
+    m_free(pixels);
+
+    return result;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Display_framebuffer_obj, lvgl_esp32_Display_framebuffer);
+
+static mp_obj_t lvgl_esp32_Display_bus_stats(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Display_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+    esp_lcd_host_stats_t stats = { 0 };
+
+    if (self->io_handle != NULL)
+    {
+        ESP_ERROR_CHECK(esp_lcd_host_panel_io_get_stats(self->bus_io, &stats));
+    }
+
+    mp_obj_t dict = mp_obj_new_dict(6);
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_transactions), mp_obj_new_int_from_ull(stats.transactions));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_color_transfers), mp_obj_new_int_from_ull(stats.color_transfers));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_commands), mp_obj_new_int_from_ull(stats.commands));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_bytes), mp_obj_new_int_from_ull(stats.bytes));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_pixels), mp_obj_new_int_from_ull(stats.pixels));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_busy_us), mp_obj_new_int_from_ull(stats.busy_us));
+
+    return dict;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Display_bus_stats_obj, lvgl_esp32_Display_bus_stats);
+
+static mp_obj_t lvgl_esp32_Display_reset_bus_stats(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Display_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    if (self->io_handle != NULL)
+    {
+        ESP_ERROR_CHECK(esp_lcd_host_panel_io_reset_stats(self->bus_io));
+    }
+
+    return mp_obj_new_int_from_uint(0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Display_reset_bus_stats_obj, lvgl_esp32_Display_reset_bus_stats);
+#endif
 
 static mp_obj_t lvgl_esp32_Display_make_new(
     const mp_obj_type_t *type,
@@ -160,31 +1253,47 @@ static mp_obj_t lvgl_esp32_Display_make_new(
     {
         ARG_width,          // width of the display
         ARG_height,         // height of the display
-        ARG_spi,            // configured SPI instance
+        ARG_spi,            // configured SPI instance, None when using i80
         ARG_reset,          // RESET pin number
-        ARG_dc,             // DC pin number
+        ARG_dc,             // DC pin number, -1 for i80 (the bus has it) and QSPI (no DC line)
         ARG_cs,             // CS pin number
-        ARG_pixel_clock,    // Pixel clock in Hz
+        ARG_pixel_clock,    // Pixel clock in Hz, AUTO for the baudrate of the SPI bus
         ARG_swap_xy,        // swap X and Y axis
         ARG_mirror_x,       // mirror on X axis
         ARG_mirror_y,       // mirror on Y axis
         ARG_invert,         // invert colors
         ARG_bgr,            // use BGR element order
+        ARG_little_endian,  // panel accepts little-endian RGB565, so no byte swapping is needed
+        ARG_rgb444,         // send colors as RGB444, a quarter fewer bytes for less color depth
+        ARG_te,             // TE pin number, -1 when not connected
+        ARG_i80,            // configured I80 instance, instead of spi
+        ARG_qspi,           // QSPI panel, needs spi with data2 and data3 and leaves dc unused
+        ARG_init_cmds,      // (command, data[, delay_ms]) init sequence of the controller, required for qspi
+        ARG_queue_depth,    // transactions the panel IO can queue, or AUTO
+        ARG_poll_threshold, // SPI flushes up to this many bytes are polled instead of queued, 0 to never poll
     };
 
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_width, MP_ARG_INT | MP_ARG_REQUIRED },
         { MP_QSTR_height, MP_ARG_INT | MP_ARG_REQUIRED },
-        { MP_QSTR_spi, MP_ARG_OBJ | MP_ARG_REQUIRED },
+        { MP_QSTR_spi, MP_ARG_OBJ, { .u_obj = mp_const_none }},
         { MP_QSTR_reset, MP_ARG_INT | MP_ARG_REQUIRED },
-        { MP_QSTR_dc, MP_ARG_INT | MP_ARG_REQUIRED },
+        { MP_QSTR_dc, MP_ARG_INT, { .u_int = -1 }},
         { MP_QSTR_cs, MP_ARG_INT | MP_ARG_REQUIRED },
-        { MP_QSTR_pixel_clock, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 20 * 1000 * 1000 }},
+        { MP_QSTR_pixel_clock, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = DEFAULT_PIXEL_CLOCK }},
         { MP_QSTR_swap_xy, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false }},
         { MP_QSTR_mirror_x, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false }},
         { MP_QSTR_mirror_y, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false }},
         { MP_QSTR_invert, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false }},
         { MP_QSTR_bgr, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false }},
+        { MP_QSTR_little_endian, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false }},
+        { MP_QSTR_rgb444, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false }},
+        { MP_QSTR_te, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = -1 }},
+        { MP_QSTR_i80, MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none }},
+        { MP_QSTR_qspi, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false }},
+        { MP_QSTR_init_cmds, MP_ARG_OBJ | MP_ARG_KW_ONLY, { .u_obj = mp_const_none }},
+        { MP_QSTR_queue_depth, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = DEFAULT_QUEUE_DEPTH }},
+        { MP_QSTR_poll_threshold, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = DEFAULT_POLL_THRESHOLD }},
     };
 
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
@@ -195,23 +1304,168 @@ static mp_obj_t lvgl_esp32_Display_make_new(
     self->width = args[ARG_width].u_int;
     self->height = args[ARG_height].u_int;
 
-    self->spi = (lvgl_esp32_SPI_obj_t *) MP_OBJ_TO_PTR(args[ARG_spi].u_obj);
+    if ((args[ARG_spi].u_obj == mp_const_none) == (args[ARG_i80].u_obj == mp_const_none))
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Either spi or i80 is required"));
+    }
+
+    self->spi = NULL;
+    self->i80 = NULL;
+    if (args[ARG_i80].u_obj != mp_const_none)
+    {
+        self->i80 = (lvgl_esp32_I80_obj_t *) MP_OBJ_TO_PTR(args[ARG_i80].u_obj);
+    }
+    else
+    {
+        self->spi = (lvgl_esp32_SPI_obj_t *) MP_OBJ_TO_PTR(args[ARG_spi].u_obj);
+    }
+
+    self->qspi = args[ARG_qspi].u_bool;
+    if (self->qspi && (self->spi == NULL || self->spi->data2 < 0 || self->spi->data3 < 0))
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("qspi needs an SPI bus with data2 and data3"));
+    }
+
+    // Only the DCS commands sent after it are shared with the ST7789, QSPI controllers differ in everything else
+    self->init_cmds = mp_const_none;
+    if (args[ARG_init_cmds].u_obj != mp_const_none)
+    {
+        size_t count;
+        mp_obj_t *cmds;
+        mp_obj_get_array(args[ARG_init_cmds].u_obj, &count, &cmds);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t len;
+            mp_obj_t *cmd;
+            mp_obj_get_array(cmds[i], &len, &cmd);
+
+            mp_buffer_info_t bufinfo;
+            if (len < 2
+                || len > 3
+                || mp_obj_get_int(cmd[0]) < 0
+                || !mp_get_buffer(cmd[1], &bufinfo, MP_BUFFER_READ)
+                || (len == 3 && mp_obj_get_int(cmd[2]) < 0))
+            {
+                mp_raise_ValueError(MP_ERROR_TEXT("init_cmds entries are (command, data[, delay_ms])"));
+            }
+        }
+
+        self->init_cmds = mp_obj_new_tuple(count, cmds);
+    }
+    else if (self->qspi)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("qspi needs the init_cmds of the panel controller"));
+    }
+    // Only a plain SPI panel has its DC pin driven by the panel IO
+    if (self->spi != NULL && !self->qspi && args[ARG_dc].u_int < 0)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("dc is required for an SPI panel"));
+    }
+
     self->reset = args[ARG_reset].u_int;
     self->dc = args[ARG_dc].u_int;
     self->cs = args[ARG_cs].u_int;
-    self->pixel_clock = args[ARG_pixel_clock].u_int;
+
+    if (args[ARG_pixel_clock].u_int == LVGL_ESP32_AUTO)
+    {
+        self->pixel_clock = self->spi != NULL ? self->spi->baudrate : DEFAULT_PIXEL_CLOCK;
+    }
+    else if (args[ARG_pixel_clock].u_int > 0)
+    {
+        self->pixel_clock = args[ARG_pixel_clock].u_int;
+    }
+    else
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid pixel_clock"));
+    }
+
+    mp_int_t queue_depth = args[ARG_queue_depth].u_int;
+    if ((queue_depth < MIN_QUEUE_DEPTH || queue_depth > MAX_QUEUE_DEPTH) && queue_depth != LVGL_ESP32_AUTO)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid queue_depth"));
+    }
+
+    // Until the Wrapper has a plan, AUTO uses the default
+    self->auto_queue_depth = queue_depth == LVGL_ESP32_AUTO;
+    self->queue_depth = self->auto_queue_depth ? DEFAULT_QUEUE_DEPTH : queue_depth;
 
     self->swap_xy = args[ARG_swap_xy].u_bool;
     self->mirror_x = args[ARG_mirror_x].u_bool;
     self->mirror_y = args[ARG_mirror_y].u_bool;
+    self->base_swap_xy = self->swap_xy;
+    self->base_mirror_x = self->mirror_x;
+    self->base_mirror_y = self->mirror_y;
+    self->rotation = 0;
     self->invert = args[ARG_invert].u_bool;
     self->bgr = args[ARG_bgr].u_bool;
+    self->little_endian = args[ARG_little_endian].u_bool;
+    self->rgb444 = args[ARG_rgb444].u_bool;
+
+    // Packed pixels are no 16-bit units, which the i80 bus would swap and little_endian would reorder
+    if (self->rgb444 && (self->i80 != NULL || self->little_endian))
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("rgb444 needs an SPI bus and no little_endian"));
+    }
+
+    self->swap_bytes = !self->little_endian && self->i80 == NULL && !self->rgb444;
+
+    if (args[ARG_te].u_int < -1 || args[ARG_te].u_int >= GPIO_NUM_MAX)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid TE pin"));
+    }
+
+    self->te = args[ARG_te].u_int;
+    self->te_semaphore = NULL;
+    self->te_last_us = 0;
+    self->te_period_us = 0;
+    self->te_count = 0;
 
     self->transfer_done_cb = NULL;
     self->transfer_done_user_data = NULL;
+    self->rotation_cb = NULL;
+    self->rotation_user_data = NULL;
+    self->lock_cb = NULL;
+    self->unlock_cb = NULL;
+    self->lock_user_data = NULL;
+
+    self->trans_tag_head = 0;
+    self->trans_tag_tail = 0;
+
+    self->fill_buf = NULL;
+    self->fill_buf_size = 0;
+    self->fill_value = FILL_VALUE_NONE;
+    self->fill_pending = 0;
+    self->fill_semaphore = NULL;
+
+    self->blit_buf = mp_const_none;
+    self->blit_callback = mp_const_none;
+    self->blit_pending = false;
+    self->blit_semaphore = NULL;
+
+    if (args[ARG_poll_threshold].u_int < 0)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid poll_threshold"));
+    }
+
+    self->window_valid = false;
+    self->continued_writes = 0;
+
+    self->scroll_top = 0;
+    self->scroll_height = 0;
+    self->scroll_offset = 0;
+    self->foreign_writes = 0;
+
+    self->poll_threshold = args[ARG_poll_threshold].u_int;
+    self->poll_max = 0;
+    self->polled_flushes = 0;
+    self->queued_flushes = 0;
+    self->color_bytes = 0;
+    self->color_transactions = 0;
 
     self->panel = NULL;
     self->io_handle = NULL;
+    self->bus_io = NULL;
 
     return MP_OBJ_FROM_PTR(self);
 }
@@ -220,6 +1474,19 @@ static const mp_rom_map_elem_t lvgl_esp32_Display_locals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_init), MP_ROM_PTR(&lvgl_esp32_Display_init_obj) },
     { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&lvgl_esp32_Display_deinit_obj) },
     { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&lvgl_esp32_Display_deinit_obj) },
+    { MP_ROM_QSTR(MP_QSTR_fill_rect), MP_ROM_PTR(&lvgl_esp32_Display_fill_rect_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_scroll_area), MP_ROM_PTR(&lvgl_esp32_Display_set_scroll_area_obj) },
+    { MP_ROM_QSTR(MP_QSTR_scroll), MP_ROM_PTR(&lvgl_esp32_Display_scroll_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_rotation), MP_ROM_PTR(&lvgl_esp32_Display_set_rotation_obj) },
+    { MP_ROM_QSTR(MP_QSTR_blit), MP_ROM_PTR(&lvgl_esp32_Display_blit_obj) },
+    { MP_ROM_QSTR(MP_QSTR_blit_async), MP_ROM_PTR(&lvgl_esp32_Display_blit_async_obj) },
+    { MP_ROM_QSTR(MP_QSTR_blit_busy), MP_ROM_PTR(&lvgl_esp32_Display_blit_busy_obj) },
+    { MP_ROM_QSTR(MP_QSTR_blit_wait), MP_ROM_PTR(&lvgl_esp32_Display_blit_wait_obj) },
+#if LVGL_ESP32_HOST
+    { MP_ROM_QSTR(MP_QSTR_framebuffer), MP_ROM_PTR(&lvgl_esp32_Display_framebuffer_obj) },
+    { MP_ROM_QSTR(MP_QSTR_bus_stats), MP_ROM_PTR(&lvgl_esp32_Display_bus_stats_obj) },
+    { MP_ROM_QSTR(MP_QSTR_reset_bus_stats), MP_ROM_PTR(&lvgl_esp32_Display_reset_bus_stats_obj) },
+#endif
 };
 
 static MP_DEFINE_CONST_DICT(lvgl_esp32_Display_locals, lvgl_esp32_Display_locals_table);
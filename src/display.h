@@ -1,12 +1,25 @@
 #ifndef __LVGL_ESP32_DISPLAY_H__
 #define __LVGL_ESP32_DISPLAY_H__
 
+#include "i80.h"
 #include "spi.h"
 
 #include "esp_lcd_types.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "py/obj.h"
 
-typedef void (*lvgl_esp32_transfer_done_cb_t)(void *);
+// Called from the interrupt of the transfer, returns whether it woke a task of a higher priority
+typedef bool (*lvgl_esp32_transfer_done_cb_t)(void *);
+typedef void (*lvgl_esp32_rotation_cb_t)(void *);
+typedef void (*lvgl_esp32_lock_cb_t)(void *);
+
+// Color transfers complete in the order they were queued, each one has a tag saying what to do when it is done. The
+// ring is larger than the transaction queue, so it can never overflow.
+#define LVGL_ESP32_TRANS_TAG_RING_SIZE  16
+#define LVGL_ESP32_TRANS_TAG_NOTIFY     (1 << 0)    // call transfer_done_cb
+#define LVGL_ESP32_TRANS_TAG_FILL       (1 << 1)    // reads from the fill pattern buffer
+#define LVGL_ESP32_TRANS_TAG_BLIT       (1 << 2)    // sends a Python buffer for blit()
 
 typedef struct lvgl_esp32_Display_obj_t
 {
@@ -15,34 +28,163 @@ typedef struct lvgl_esp32_Display_obj_t
     uint16_t width;
     uint16_t height;
 
+    // Exactly one of the buses is set
     lvgl_esp32_SPI_obj_t *spi;
+    lvgl_esp32_I80_obj_t *i80;
     uint8_t reset;
-    uint8_t dc;
+    int8_t dc;
     uint8_t cs;
     uint32_t pixel_clock;
 
+    // Transactions the panel IO can have queued, auto_queue_depth lets the Wrapper pick it for its draw buffers
+    uint8_t queue_depth;
+    bool auto_queue_depth;
+
+    // Orientation the panel is set to. It is the one given to the constructor turned clockwise by rotation quarter
+    // turns, which also swaps width and height when odd.
     bool swap_xy;
     bool mirror_x;
     bool mirror_y;
+    bool base_swap_xy;
+    bool base_mirror_x;
+    bool base_mirror_y;
+    uint8_t rotation;
     bool invert;
     bool bgr;
+    bool little_endian;
+
+    // Commands are framed for a QSPI panel and colors are sent over four lines
+    bool qspi;
+
+    // Tuple of (command, data[, delay_ms]) sent instead of the init sequence of the ST7789 driver, or None
+    mp_obj_t init_cmds;
+
+    // Colors go to the panel as RGB444, packed from LVGL's RGB565 right before they are sent
+    bool rgb444;
+
+    // LVGL's RGB565 has to be byte-swapped in software before it is sent, which the i80 bus does in hardware
+    bool swap_bytes;
+
+    // Tearing effect output of the panel, given by its interrupt at the start of every refresh
+    int8_t te;
+    SemaphoreHandle_t te_semaphore;
+    volatile int64_t te_last_us;
+    volatile int64_t te_period_us;
+    volatile uint32_t te_count;
 
     lvgl_esp32_transfer_done_cb_t transfer_done_cb;
     void *transfer_done_user_data;
 
+    // Called after set_rotation() changed the size of the display
+    lvgl_esp32_rotation_cb_t rotation_cb;
+    void *rotation_user_data;
+
+    // Taken around the methods that send to the panel from Python, against a task rendering to it at the same time
+    lvgl_esp32_lock_cb_t lock_cb;
+    lvgl_esp32_lock_cb_t unlock_cb;
+    void *lock_user_data;
+
+    uint8_t trans_tags[LVGL_ESP32_TRANS_TAG_RING_SIZE];
+    volatile uint8_t trans_tag_head;
+    volatile uint8_t trans_tag_tail;
+
+    // Pattern buffer for fills, holds fill_value (as sent over the bus) repeated. fill_pending counts the queued
+    // transfers still reading it, the last of them gives fill_semaphore.
+    uint16_t *fill_buf;
+    size_t fill_buf_size;
+    uint32_t fill_value;
+    volatile uint32_t fill_pending;
+    SemaphoreHandle_t fill_semaphore;
+
+    // Buffer of the blit in progress, referenced until the transfer is done so the GC keeps it. Its last transfer
+    // clears blit_pending and gives blit_semaphore.
+    mp_obj_t blit_buf;
+    mp_obj_t blit_callback;
+    volatile bool blit_pending;
+    SemaphoreHandle_t blit_semaphore;
+
+    // Address window of the last memory write, whose rows run to the bottom of the display. window_next_y is the row
+    // the panel continues at, continued_writes counts the writes that did so with RAMWRC.
+    bool window_valid;
+    uint16_t window_x;
+    uint16_t window_width;
+    uint16_t window_next_y;
+    uint32_t continued_writes;
+
+    // Vertical scroll area in rows of the screen, scroll_height is 0 without one. Its rows are shown moved up by
+    // scroll_offset, wrapping around, which all writes take into account.
+    uint16_t scroll_top;
+    uint16_t scroll_height;
+    uint16_t scroll_offset;
+
+    // Counts everything that changed the frame memory other than draw_bitmap and fill_rect, such as blits, scrolling
+    // or a rotation, so the Wrapper knows when what it sent before is no longer on the screen
+    uint32_t foreign_writes;
+
+    // SPI flushes of up to poll_max bytes (poll_threshold, limited to what the bus takes at once) are sent with a
+    // polling transaction and complete before draw_bitmap returns
+    uint32_t poll_threshold;
+    size_t poll_max;
+    uint32_t polled_flushes;
+    uint32_t queued_flushes;
+
+    // Pixel data handed to the bus and the transactions it took, for the statistics of the Wrapper
+    uint64_t color_bytes;
+    uint32_t color_transactions;
+
     esp_lcd_panel_handle_t panel;
     esp_lcd_panel_io_handle_t io_handle;
+
+    // Panel IO on the bus itself, below the QSPI framing. The same as io_handle otherwise.
+    esp_lcd_panel_io_handle_t bus_io;
 } lvgl_esp32_Display_obj_t;
 
 extern const mp_obj_type_t lvgl_esp32_Display_type;
 
+// Sends native RGB565 pixels, which are packed in place first on an RGB444 display. The transfer done callback is only
+// called when notify is set.
 void lvgl_esp32_Display_draw_bitmap(
     lvgl_esp32_Display_obj_t *self,
     int x_start,
     int y_start,
     int x_end,
     int y_end,
-    const void *data
+    const void *data,
+    bool notify
+);
+
+// Fills a rectangle with a single RGB565 color, given in the byte order LVGL renders in. The transfer done callback is
+// only called for the last transaction when notify is set.
+void lvgl_esp32_Display_fill_rect(
+    lvgl_esp32_Display_obj_t *self,
+    int x,
+    int y,
+    int width,
+    int height,
+    uint16_t color,
+    bool notify
 );
 
+// Defines the rows of the screen that scroll in hardware, a height of 0 removes the scroll area. Only valid without
+// swap_xy and mirror_y, in which case rows of the screen are rows of the frame memory.
+void lvgl_esp32_Display_set_scroll_area(lvgl_esp32_Display_obj_t *self, int top, int height);
+
+// Moves the contents of the scroll area up by dy rows (down when negative), the rows that come in at the other side
+// wrap around and still have to be drawn
+void lvgl_esp32_Display_scroll(lvgl_esp32_Display_obj_t *self, int dy);
+
+// Turns the display clockwise by rotation quarter turns from the orientation given to the constructor. Only the
+// memory access control of the panel changes, the image on it has to be drawn again.
+void lvgl_esp32_Display_set_rotation(lvgl_esp32_Display_obj_t *self, uint8_t rotation);
+
+// Time the bus takes for the given number of bytes at the pixel clock, without any overhead
+uint64_t lvgl_esp32_Display_bus_time_us(lvgl_esp32_Display_obj_t *self, uint64_t bytes);
+
+// Sizes the settings left to AUTO (bus transfer size and queue depth) for flushes of flush_size bytes, of which up to
+// flushes_in_flight are queued at once. An initialized display is set up again when they change.
+void lvgl_esp32_Display_plan_bus(lvgl_esp32_Display_obj_t *self, size_t flush_size, uint8_t flushes_in_flight);
+
+// Waits for the next TE pulse, returns false on timeout or when the display has no TE pin
+bool lvgl_esp32_Display_wait_te(lvgl_esp32_Display_obj_t *self, uint32_t timeout_ms);
+
 #endif /* __LVGL_ESP32_DISPLAY_H__ */
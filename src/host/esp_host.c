@@ -0,0 +1,506 @@
+// Host stand-ins for the small ESP-IDF system APIs used by the module: errors, logging, timers, cycle counter, heap,
+// tasks, semaphores, GPIO interrupts and the SPI bus
+
+#include "esp_host.h"
+
+#include "esp_cpu.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Same default as ESP-IDF when max_transfer_sz is 0 and DMA is enabled
+#define SPI_DEFAULT_MAX_TRANSFER_SZ     4092
+
+typedef struct
+{
+    bool initialized;
+    size_t max_transfer_bytes;
+    int device_count;
+} host_spi_bus_t;
+
+static host_spi_bus_t spi_buses[SPI_HOST_MAX];
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code)
+    {
+        case ESP_OK:
+            return "ESP_OK";
+        case ESP_FAIL:
+            return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:
+            return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:
+            return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE:
+            return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:
+            return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:
+            return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED:
+            return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:
+            return "ESP_ERR_TIMEOUT";
+        default:
+            return "UNKNOWN ERROR";
+    }
+}
+
+void _esp_error_check_failed(esp_err_t rc, const char *file, int line, const char *function, const char *expression)
+{
+    fprintf(stderr, "ESP_ERROR_CHECK failed: esp_err_t 0x%x (%s) at %s:%d\n", rc, esp_err_to_name(rc), file, line);
+    fprintf(stderr, "file: \"%s\" line %d\nfunc: %s\nexpression: %s\n", file, line, function, expression);
+    abort();
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    static int max_level = -1;
+
+    if (max_level < 0)
+    {
+        max_level = (int) esp_host_env_int("LVGL_ESP32_HOST_LOG", ESP_LOG_WARN);
+    }
+
+    if ((int) level > max_level)
+    {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+
+int64_t esp_host_time_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+void esp_host_sleep_until_ns(int64_t deadline)
+{
+    struct timespec ts = {
+        .tv_sec = deadline / 1000000000LL,
+        .tv_nsec = deadline % 1000000000LL,
+    };
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    {
+    }
+}
+
+int64_t esp_host_env_int(const char *name, int64_t default_value)
+{
+    const char *value = getenv(name);
+    char *end;
+
+    if (value == NULL || *value == '\0')
+    {
+        return default_value;
+    }
+
+    long long result = strtoll(value, &end, 0);
+    return *end == '\0' ? result : default_value;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    static int64_t start = 0;
+
+    if (start == 0)
+    {
+        start = esp_host_time_ns();
+    }
+
+    return (esp_host_time_ns() - start) / 1000;
+}
+
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void)
+{
+    return (esp_cpu_cycle_count_t) esp_host_time_ns();
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    return malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    return calloc(n, size);
+}
+
+void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps)
+{
+    // aligned_alloc requires the size to be a multiple of the alignment
+    return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    return SIZE_MAX;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return SIZE_MAX;
+}
+
+void vTaskDelay(const TickType_t ticks)
+{
+    esp_host_sleep_until_ns(esp_host_time_ns() + (int64_t) ticks * portTICK_PERIOD_MS * 1000000LL);
+}
+
+struct host_task_t
+{
+    TaskFunction_t task_code;
+    void *parameters;
+    pthread_t thread;
+};
+
+// Threads not created through xTaskCreatePinnedToCore, such as the main one, get a handle of their own too
+static __thread struct host_task_t thread_task;
+static __thread struct host_task_t *current_task;
+
+static void *host_task_main(void *arg)
+{
+    struct host_task_t *task = (struct host_task_t *) arg;
+
+    current_task = task;
+    task->task_code(task->parameters);
+
+    // FreeRTOS tasks must not return, but be forgiving
+    vTaskDelete(NULL);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(
+    TaskFunction_t task_code,
+    const char *name,
+    const uint32_t stack_depth,
+    void *parameters,
+    UBaseType_t priority,
+    TaskHandle_t *created_task,
+    const BaseType_t core_id
+)
+{
+    struct host_task_t *task = calloc(1, sizeof(struct host_task_t));
+    if (task == NULL)
+    {
+        return pdFAIL;
+    }
+
+    task->task_code = task_code;
+    task->parameters = parameters;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (stack_depth > 0)
+    {
+        pthread_attr_setstacksize(&attr, stack_depth < PTHREAD_STACK_MIN ? PTHREAD_STACK_MIN : stack_depth);
+    }
+
+    int result = pthread_create(&task->thread, &attr, host_task_main, task);
+    pthread_attr_destroy(&attr);
+
+    if (result != 0)
+    {
+        free(task);
+        return pdFAIL;
+    }
+
+    if (created_task != NULL)
+    {
+        *created_task = task;
+    }
+
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    assert(task == NULL || task == current_task);
+
+    free(current_task);
+    current_task = NULL;
+    pthread_exit(NULL);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return current_task != NULL ? current_task : &thread_task;
+}
+
+struct host_semaphore_t
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool given;
+};
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    struct host_semaphore_t *semaphore = calloc(1, sizeof(struct host_semaphore_t));
+    if (semaphore == NULL)
+    {
+        return NULL;
+    }
+
+    // Timeouts are deadlines on CLOCK_MONOTONIC, like everything else on the host
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&semaphore->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&semaphore->lock, NULL);
+
+    return semaphore;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    pthread_cond_destroy(&semaphore->cond);
+    pthread_mutex_destroy(&semaphore->lock);
+    free(semaphore);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    int64_t deadline = esp_host_time_ns() + (int64_t) ticks_to_wait * portTICK_PERIOD_MS * 1000000LL;
+    struct timespec ts = {
+        .tv_sec = deadline / 1000000000LL,
+        .tv_nsec = deadline % 1000000000LL,
+    };
+
+    pthread_mutex_lock(&semaphore->lock);
+    while (!semaphore->given && ticks_to_wait > 0)
+    {
+        if (ticks_to_wait == portMAX_DELAY)
+        {
+            pthread_cond_wait(&semaphore->cond, &semaphore->lock);
+        }
+        else if (pthread_cond_timedwait(&semaphore->cond, &semaphore->lock, &ts) == ETIMEDOUT)
+        {
+            break;
+        }
+    }
+
+    BaseType_t taken = semaphore->given ? pdTRUE : pdFALSE;
+    semaphore->given = false;
+    pthread_mutex_unlock(&semaphore->lock);
+
+    return taken;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    pthread_mutex_lock(&semaphore->lock);
+    BaseType_t given = semaphore->given ? pdFALSE : pdTRUE;
+    semaphore->given = true;
+    pthread_cond_signal(&semaphore->cond);
+    pthread_mutex_unlock(&semaphore->lock);
+
+    return given;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t *higher_priority_task_woken)
+{
+    if (higher_priority_task_woken != NULL)
+    {
+        *higher_priority_task_woken = pdFALSE;
+    }
+
+    return xSemaphoreGive(semaphore);
+}
+
+typedef struct
+{
+    gpio_int_type_t intr_type;
+    gpio_isr_t handler;
+    void *args;
+} host_gpio_t;
+
+static host_gpio_t gpios[GPIO_NUM_MAX];
+static pthread_mutex_t gpio_lock = PTHREAD_MUTEX_INITIALIZER;
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    if (config == NULL || (config->pin_bit_mask >> GPIO_NUM_MAX) != 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&gpio_lock);
+    for (int pin = 0; pin < GPIO_NUM_MAX; pin++)
+    {
+        if (config->pin_bit_mask & (1ULL << pin))
+        {
+            gpios[pin].intr_type = config->mode == GPIO_MODE_INPUT ? config->intr_type : GPIO_INTR_DISABLE;
+        }
+    }
+    pthread_mutex_unlock(&gpio_lock);
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&gpio_lock);
+    gpios[gpio_num].intr_type = GPIO_INTR_DISABLE;
+    pthread_mutex_unlock(&gpio_lock);
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    static bool installed = false;
+
+    if (installed)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    installed = true;
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&gpio_lock);
+    gpios[gpio_num].handler = isr_handler;
+    gpios[gpio_num].args = args;
+    pthread_mutex_unlock(&gpio_lock);
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num)
+{
+    return gpio_isr_handler_add(gpio_num, NULL, NULL);
+}
+
+void esp_host_gpio_pulse_te(void)
+{
+    // Handlers run with the lock held so they can not be removed while running
+    pthread_mutex_lock(&gpio_lock);
+    for (int pin = 0; pin < GPIO_NUM_MAX; pin++)
+    {
+        if (gpios[pin].handler != NULL
+            && (gpios[pin].intr_type == GPIO_INTR_POSEDGE || gpios[pin].intr_type == GPIO_INTR_ANYEDGE))
+        {
+            gpios[pin].handler(gpios[pin].args);
+        }
+    }
+    pthread_mutex_unlock(&gpio_lock);
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t *bus_config, spi_dma_chan_t dma_chan)
+{
+    if (host_id < 0 || host_id >= SPI_HOST_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    host_spi_bus_t *bus = &spi_buses[host_id];
+
+    if (bus->initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    bus->initialized = true;
+    bus->max_transfer_bytes = bus_config->max_transfer_sz > 0
+        ? (size_t) bus_config->max_transfer_sz
+        : SPI_DEFAULT_MAX_TRANSFER_SZ;
+    bus->device_count = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host_id)
+{
+    if (host_id < 0 || host_id >= SPI_HOST_MAX || !spi_buses[host_id].initialized)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (spi_buses[host_id].device_count > 0)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    spi_buses[host_id].initialized = false;
+
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_get_max_transaction_len(spi_host_device_t host_id, size_t *max_bytes)
+{
+    if (host_id < 0 || host_id >= SPI_HOST_MAX || !spi_buses[host_id].initialized)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *max_bytes = spi_buses[host_id].max_transfer_bytes;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_host_spi_bus_attach(spi_host_device_t host_id, size_t *max_transfer_bytes)
+{
+    if (host_id < 0 || host_id >= SPI_HOST_MAX || !spi_buses[host_id].initialized)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    spi_buses[host_id].device_count++;
+    *max_transfer_bytes = spi_buses[host_id].max_transfer_bytes;
+
+    return ESP_OK;
+}
+
+void esp_host_spi_bus_detach(spi_host_device_t host_id)
+{
+    if (host_id >= 0 && host_id < SPI_HOST_MAX && spi_buses[host_id].device_count > 0)
+    {
+        spi_buses[host_id].device_count--;
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef __LVGL_ESP32_HOST_ESP_HOST_H__
+#define __LVGL_ESP32_HOST_ESP_HOST_H__
+
+// Glue shared between the host stand-ins, not part of ESP-IDF
+
+#include "esp_err.h"
+#include "hal/spi_types.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Nanoseconds on CLOCK_MONOTONIC
+int64_t esp_host_time_ns(void);
+
+// Sleeps until the given esp_host_time_ns() deadline
+void esp_host_sleep_until_ns(int64_t deadline);
+
+// Reads an integer from the environment, returning the default when it is unset or malformed
+int64_t esp_host_env_int(const char *name, int64_t default_value);
+
+// Devices attach to an initialized bus, which can only be freed once all of them are gone
+esp_err_t esp_host_spi_bus_attach(spi_host_device_t host_id, size_t *max_transfer_bytes);
+void esp_host_spi_bus_detach(spi_host_device_t host_id);
+
+// Calls the interrupt handlers of all pins configured for rising edges, the emulated panel pulses its TE output this way
+void esp_host_gpio_pulse_te(void);
+
+#endif /* __LVGL_ESP32_HOST_ESP_HOST_H__ */
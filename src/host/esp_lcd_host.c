@@ -0,0 +1,1185 @@
+// Host stand-in for the esp_lcd SPI and i80 panel IO and the ST7789 panel driver.
+//
+// The panel IO is wired to an emulated ST7789 controller with its own graphics RAM. Like the ESP-IDF driver, commands
+// are sent synchronously once all queued color transactions have finished, while color data is queued for a worker
+// thread. The worker takes as long as the modelled bus would and then reports completion via on_color_trans_done, so
+// callbacks arrive asynchronously from another thread just like they do from the SPI ISR on a device.
+//
+// The bus is modelled at the pixel clock of the panel IO configuration, moving one bit (SPI) or one bus width (i80) per
+// clock. In quad mode color data moves four bits per clock and commands are decoded from their QSPI framing.
+// LVGL_ESP32_HOST_PCLK_HZ overrides the clock (0 disables throttling altogether) and LVGL_ESP32_HOST_TRANS_OVERHEAD_NS
+// adds a fixed cost to every transaction.
+//
+// The panel refreshes at LVGL_ESP32_HOST_REFRESH_HZ (60 by default). Once TEON was sent, the start of every refresh
+// pulses the TE output, which reaches the interrupt handlers of GPIO inputs configured for rising edges.
+
+#include "esp_lcd_host.h"
+
+#include "esp_host.h"
+#include "esp_lcd_panel_commands.h"
+#include "esp_lcd_panel_interface.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_io_interface.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_panel_vendor.h"
+#include "esp_log.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "lcd_host";
+
+#define ST7789_CMD_RAMCTRL              0xB0
+#define ST7789_DATA_LITTLE_ENDIAN_BIT   (1 << 3)
+
+#ifndef __containerof
+#define __containerof(ptr, type, member) ((type *) ((char *) (ptr) - offsetof(type, member)))
+#endif
+
+// Same default as ESP-IDF when max_transfer_bytes is 0
+#define I80_DEFAULT_MAX_TRANSFER_BYTES  4092
+
+#define GRAM_WIDTH                      ESP_LCD_HOST_GRAM_WIDTH
+#define GRAM_HEIGHT                     ESP_LCD_HOST_GRAM_HEIGHT
+
+struct esp_lcd_i80_bus_t
+{
+    int bus_width;
+    size_t max_transfer_bytes;
+    int device_count;
+};
+
+typedef struct
+{
+    int lcd_cmd;                // -1 for pixel data continuing the previous memory write
+    const uint8_t *data;
+    size_t size;
+    bool notify;                // last chunk of a tx_color call
+} host_trans_t;
+
+typedef struct
+{
+    esp_lcd_panel_io_t base;
+
+    // The bus the IO is attached to, the i80 one when set and the SPI one otherwise
+    spi_host_device_t spi_host;
+    esp_lcd_i80_bus_handle_t i80_bus;
+
+    // Bus model
+    uint64_t pclk_hz;
+    int bits_per_clock;         // for color data
+    int cmd_bits_per_clock;     // for commands and their parameters
+    int cmd_bytes;
+    bool qspi;                  // commands are framed as 0x02/0x32, 0x00, command, 0x00
+    int64_t overhead_ns;
+    int64_t bus_free_at;
+    bool swap_color_bytes;
+    size_t max_transfer_bytes;
+
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    void *user_ctx;
+
+    // Queued color transactions, serviced by the worker thread
+    pthread_t worker;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    host_trans_t *queue;
+    size_t queue_depth;
+    size_t queue_head;
+    size_t queue_count;
+    bool stopping;
+
+    // Refresh of the glass, pulses TE
+    pthread_t scanout;
+    int64_t refresh_period_ns;
+
+    // Emulated controller, only touched by whoever currently owns the bus
+    uint16_t gram[GRAM_WIDTH * GRAM_HEIGHT];
+    uint8_t madctl;
+    uint8_t colmod;
+    uint8_t ramctrl[2];
+    uint16_t column_start;
+    uint16_t column_end;
+    uint16_t row_start;
+    uint16_t row_end;
+    uint16_t column;
+    uint16_t row;
+    uint8_t partial[3];
+    size_t partial_len;
+    uint16_t scroll_top;
+    uint16_t scroll_height;
+    uint16_t scroll_start;
+    bool inverted;
+    bool display_on;
+    bool sleeping;
+    bool tearing_effect;
+
+    esp_lcd_host_stats_t stats;
+} host_panel_io_t;
+
+typedef struct
+{
+    esp_lcd_panel_t base;
+    esp_lcd_panel_io_handle_t io;
+    int x_gap;
+    int y_gap;
+    uint8_t fb_bits_per_pixel;
+    uint8_t madctl_val;
+    uint8_t colmod_val;
+    uint8_t ramctl_val_1;
+    uint8_t ramctl_val_2;
+} host_st7789_panel_t;
+
+static esp_err_t host_io_tx_param(esp_lcd_panel_io_t *io, int lcd_cmd, const void *param, size_t param_size);
+
+static void stats_add(uint64_t *counter, uint64_t value)
+{
+    __atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+static void controller_reset(host_panel_io_t *io)
+{
+    io->madctl = 0;
+    io->colmod = 0x66;
+    io->ramctrl[0] = 0x00;
+    io->ramctrl[1] = 0xF0;
+    io->column_start = 0;
+    io->column_end = GRAM_WIDTH - 1;
+    io->row_start = 0;
+    io->row_end = GRAM_HEIGHT - 1;
+    io->column = 0;
+    io->row = 0;
+    io->partial_len = 0;
+    io->scroll_top = 0;
+    io->scroll_height = GRAM_HEIGHT;
+    io->scroll_start = 0;
+    io->inverted = false;
+    io->display_on = false;
+    io->sleeping = true;
+    io->tearing_effect = false;
+}
+
+static void controller_put_pixel(host_panel_io_t *io, uint16_t value)
+{
+    if (io->column <= io->column_end && io->row <= io->row_end)
+    {
+        bool mv = io->madctl & LCD_CMD_MV_BIT;
+        int columns = mv ? GRAM_HEIGHT : GRAM_WIDTH;
+        int rows = mv ? GRAM_WIDTH : GRAM_HEIGHT;
+        int c = io->column;
+        int r = io->row;
+
+        if (c < columns && r < rows)
+        {
+            if (io->madctl & LCD_CMD_MX_BIT)
+            {
+                c = columns - 1 - c;
+            }
+            if (io->madctl & LCD_CMD_MY_BIT)
+            {
+                r = rows - 1 - r;
+            }
+
+            int x = mv ? r : c;
+            int y = mv ? c : r;
+            io->gram[y * GRAM_WIDTH + x] = value;
+            io->stats.pixels++;
+        }
+    }
+
+    // The write pointer wraps around inside the window set by CASET and RASET
+    if (++io->column > io->column_end)
+    {
+        io->column = io->column_start;
+        if (++io->row > io->row_end)
+        {
+            io->row = io->row_start;
+        }
+    }
+}
+
+static uint16_t rgb444_to_rgb565(uint16_t pixel)
+{
+    uint16_t r = (pixel >> 8) & 0xF;
+    uint16_t g = (pixel >> 4) & 0xF;
+    uint16_t b = pixel & 0xF;
+
+    return ((r << 1 | r >> 3) << 11) | ((g << 2 | g >> 2) << 5) | (b << 1 | b >> 3);
+}
+
+static void controller_write(host_panel_io_t *io, const uint8_t *data, size_t size)
+{
+    size_t unit;
+
+    switch (io->colmod & 0x7)
+    {
+        case 0x3:
+            unit = 3; // two 12-bit pixels
+            break;
+        case 0x5:
+            unit = 2;
+            break;
+        default:
+            unit = 3; // one 18-bit pixel
+            break;
+    }
+
+    for (size_t i = 0; i < size; i++)
+    {
+        io->partial[io->partial_len++] = data[i];
+        if (io->partial_len < unit)
+        {
+            continue;
+        }
+        io->partial_len = 0;
+
+        const uint8_t *p = io->partial;
+        switch (io->colmod & 0x7)
+        {
+            case 0x3:
+                controller_put_pixel(io, rgb444_to_rgb565(p[0] << 4 | p[1] >> 4));
+                controller_put_pixel(io, rgb444_to_rgb565((p[1] & 0xF) << 8 | p[2]));
+                break;
+            case 0x5:
+                if (io->ramctrl[1] & ST7789_DATA_LITTLE_ENDIAN_BIT)
+                {
+                    controller_put_pixel(io, p[1] << 8 | p[0]);
+                }
+                else
+                {
+                    controller_put_pixel(io, p[0] << 8 | p[1]);
+                }
+                break;
+            default:
+                controller_put_pixel(io, (p[0] >> 3) << 11 | (p[1] >> 2) << 5 | (p[2] >> 3));
+                break;
+        }
+    }
+}
+
+static uint16_t param_u16(const uint8_t *param, size_t index)
+{
+    return param[index] << 8 | param[index + 1];
+}
+
+static void controller_command(host_panel_io_t *io, int lcd_cmd, const uint8_t *param, size_t param_size)
+{
+    switch (lcd_cmd)
+    {
+        case LCD_CMD_SWRESET:
+            controller_reset(io);
+            break;
+        case LCD_CMD_SLPIN:
+            io->sleeping = true;
+            break;
+        case LCD_CMD_SLPOUT:
+            io->sleeping = false;
+            break;
+        case LCD_CMD_INVOFF:
+            io->inverted = false;
+            break;
+        case LCD_CMD_INVON:
+            io->inverted = true;
+            break;
+        case LCD_CMD_DISPOFF:
+            io->display_on = false;
+            break;
+        case LCD_CMD_DISPON:
+            io->display_on = true;
+            break;
+        case LCD_CMD_CASET:
+            if (param_size >= 4)
+            {
+                io->column_start = param_u16(param, 0);
+                io->column_end = param_u16(param, 2);
+            }
+            break;
+        case LCD_CMD_RASET:
+            if (param_size >= 4)
+            {
+                io->row_start = param_u16(param, 0);
+                io->row_end = param_u16(param, 2);
+            }
+            break;
+        case LCD_CMD_RAMWR:
+            io->column = io->column_start;
+            io->row = io->row_start;
+            io->partial_len = 0;
+            controller_write(io, param, param_size);
+            break;
+        case LCD_CMD_WRMEMC:
+            controller_write(io, param, param_size);
+            break;
+        case LCD_CMD_VSCRDEF:
+            if (param_size >= 6)
+            {
+                io->scroll_top = param_u16(param, 0);
+                io->scroll_height = param_u16(param, 2);
+            }
+            break;
+        case LCD_CMD_VSCSAD:
+            if (param_size >= 2)
+            {
+                io->scroll_start = param_u16(param, 0);
+            }
+            break;
+        case LCD_CMD_TEOFF:
+            io->tearing_effect = false;
+            break;
+        case LCD_CMD_TEON:
+            io->tearing_effect = true;
+            break;
+        case LCD_CMD_MADCTL:
+            if (param_size >= 1)
+            {
+                io->madctl = param[0];
+            }
+            break;
+        case LCD_CMD_COLMOD:
+            if (param_size >= 1)
+            {
+                io->colmod = param[0];
+                io->partial_len = 0;
+            }
+            break;
+        case ST7789_CMD_RAMCTRL:
+            if (param_size >= 2)
+            {
+                io->ramctrl[0] = param[0];
+                io->ramctrl[1] = param[1];
+            }
+            break;
+        default:
+            ESP_LOGD(TAG, "Ignoring command 0x%02x", lcd_cmd);
+            break;
+    }
+}
+
+// Occupies the bus for as long as the transfer would take on the modelled bus, then applies it to the controller
+static void bus_transfer(host_panel_io_t *io, int lcd_cmd, const uint8_t *data, size_t size)
+{
+    uint64_t bytes = size + (lcd_cmd >= 0 ? io->cmd_bytes : 0);
+    int bits_per_clock = lcd_cmd >= 0 ? io->cmd_bits_per_clock : io->bits_per_clock;
+    int64_t start = esp_host_time_ns();
+
+    if (io->bus_free_at > start)
+    {
+        start = io->bus_free_at;
+    }
+
+    int64_t duration = io->overhead_ns;
+    if (io->pclk_hz > 0)
+    {
+        duration += (int64_t) (bytes * 8 * 1000000000ULL / (io->pclk_hz * bits_per_clock));
+    }
+
+    io->bus_free_at = start + duration;
+    if (duration > 0)
+    {
+        esp_host_sleep_until_ns(io->bus_free_at);
+    }
+
+    stats_add(&io->stats.transactions, 1);
+    stats_add(&io->stats.bytes, bytes);
+    stats_add(&io->stats.busy_us, duration / 1000);
+
+    if (lcd_cmd >= 0)
+    {
+        stats_add(&io->stats.commands, 1);
+        controller_command(io, io->qspi ? (lcd_cmd >> 8) & 0xFF : lcd_cmd, data, size);
+    }
+    else if (io->swap_color_bytes)
+    {
+        // Like the i80 peripheral, swap the bytes of every 16-bit unit on the way out
+        uint8_t swapped[256];
+
+        for (size_t offset = 0; offset < size; offset += sizeof(swapped))
+        {
+            size_t length = size - offset < sizeof(swapped) ? size - offset : sizeof(swapped);
+
+            for (size_t i = 0; i + 1 < length; i += 2)
+            {
+                swapped[i] = data[offset + i + 1];
+                swapped[i + 1] = data[offset + i];
+            }
+            if (length & 1)
+            {
+                swapped[length - 1] = data[offset + length - 1];
+            }
+
+            controller_write(io, swapped, length);
+        }
+    }
+    else
+    {
+        controller_write(io, data, size);
+    }
+}
+
+static void *host_io_worker(void *arg)
+{
+    host_panel_io_t *io = (host_panel_io_t *) arg;
+
+    pthread_mutex_lock(&io->lock);
+    for (;;)
+    {
+        while (io->queue_count == 0 && !io->stopping)
+        {
+            pthread_cond_wait(&io->cond, &io->lock);
+        }
+
+        if (io->queue_count == 0)
+        {
+            break;
+        }
+
+        host_trans_t trans = io->queue[io->queue_head];
+        pthread_mutex_unlock(&io->lock);
+
+        bus_transfer(io, trans.lcd_cmd, trans.data, trans.size);
+
+        if (trans.notify && io->on_color_trans_done != NULL)
+        {
+            esp_lcd_panel_io_event_data_t edata;
+            io->on_color_trans_done(&io->base, &edata, io->user_ctx);
+        }
+
+        // Like on a device, the queue slot is only released after the done callback has run
+        pthread_mutex_lock(&io->lock);
+        io->queue_head = (io->queue_head + 1) % io->queue_depth;
+        io->queue_count--;
+        pthread_cond_broadcast(&io->cond);
+    }
+    pthread_mutex_unlock(&io->lock);
+
+    return NULL;
+}
+
+static void *host_io_scanout(void *arg)
+{
+    host_panel_io_t *io = (host_panel_io_t *) arg;
+    int64_t next = esp_host_time_ns();
+
+    for (;;)
+    {
+        next += io->refresh_period_ns;
+        esp_host_sleep_until_ns(next);
+
+        pthread_mutex_lock(&io->lock);
+        bool stopping = io->stopping;
+        pthread_mutex_unlock(&io->lock);
+
+        if (stopping)
+        {
+            break;
+        }
+
+        // Only read here, a stale value merely shifts the first or last pulse by one refresh
+        bool pulse = __atomic_load_n(&io->tearing_effect, __ATOMIC_RELAXED)
+            && __atomic_load_n(&io->display_on, __ATOMIC_RELAXED)
+            && !__atomic_load_n(&io->sleeping, __ATOMIC_RELAXED);
+
+        if (pulse)
+        {
+            esp_host_gpio_pulse_te();
+        }
+    }
+
+    return NULL;
+}
+
+// Must be called with the lock held
+static void host_io_wait_idle(host_panel_io_t *io)
+{
+    while (io->queue_count > 0)
+    {
+        pthread_cond_wait(&io->cond, &io->lock);
+    }
+}
+
+static esp_err_t host_io_rx_param(esp_lcd_panel_io_t *io, int lcd_cmd, void *param, size_t param_size)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static esp_err_t host_io_tx_param(esp_lcd_panel_io_t *panel_io, int lcd_cmd, const void *param, size_t param_size)
+{
+    host_panel_io_t *io = __containerof(panel_io, host_panel_io_t, base);
+
+    pthread_mutex_lock(&io->lock);
+    host_io_wait_idle(io);
+    if (lcd_cmd >= 0)
+    {
+        bus_transfer(io, lcd_cmd, param, param_size);
+    }
+    pthread_mutex_unlock(&io->lock);
+
+    return ESP_OK;
+}
+
+static esp_err_t host_io_tx_color(esp_lcd_panel_io_t *panel_io, int lcd_cmd, const void *color, size_t color_size)
+{
+    host_panel_io_t *io = __containerof(panel_io, host_panel_io_t, base);
+    const uint8_t *data = color;
+
+    pthread_mutex_lock(&io->lock);
+
+    // The command goes out as a polling transaction, which has to wait for everything queued before it
+    host_io_wait_idle(io);
+    if (lcd_cmd >= 0)
+    {
+        bus_transfer(io, lcd_cmd, NULL, 0);
+    }
+    stats_add(&io->stats.color_transfers, 1);
+
+    do
+    {
+        size_t chunk = color_size < io->max_transfer_bytes ? color_size : io->max_transfer_bytes;
+
+        while (io->queue_count == io->queue_depth)
+        {
+            pthread_cond_wait(&io->cond, &io->lock);
+        }
+
+        io->queue[(io->queue_head + io->queue_count) % io->queue_depth] = (host_trans_t) {
+            .lcd_cmd = -1,
+            .data = data,
+            .size = chunk,
+            .notify = chunk == color_size,
+        };
+        io->queue_count++;
+        pthread_cond_broadcast(&io->cond);
+
+        data += chunk;
+        color_size -= chunk;
+    }
+    while (color_size > 0);
+
+    pthread_mutex_unlock(&io->lock);
+
+    return ESP_OK;
+}
+
+static esp_err_t host_io_register_event_callbacks(
+    esp_lcd_panel_io_t *panel_io,
+    const esp_lcd_panel_io_callbacks_t *cbs,
+    void *user_ctx
+)
+{
+    host_panel_io_t *io = __containerof(panel_io, host_panel_io_t, base);
+
+    pthread_mutex_lock(&io->lock);
+    io->on_color_trans_done = cbs->on_color_trans_done;
+    io->user_ctx = user_ctx;
+    pthread_mutex_unlock(&io->lock);
+
+    return ESP_OK;
+}
+
+static void host_io_detach(host_panel_io_t *io)
+{
+    if (io->i80_bus != NULL)
+    {
+        io->i80_bus->device_count--;
+    }
+    else
+    {
+        esp_host_spi_bus_detach(io->spi_host);
+    }
+}
+
+static esp_err_t host_io_del(esp_lcd_panel_io_t *panel_io)
+{
+    host_panel_io_t *io = __containerof(panel_io, host_panel_io_t, base);
+
+    pthread_mutex_lock(&io->lock);
+    host_io_wait_idle(io);
+    io->stopping = true;
+    pthread_cond_broadcast(&io->cond);
+    pthread_mutex_unlock(&io->lock);
+
+    pthread_join(io->worker, NULL);
+    pthread_join(io->scanout, NULL);
+    pthread_cond_destroy(&io->cond);
+    pthread_mutex_destroy(&io->lock);
+
+    host_io_detach(io);
+
+    free(io->queue);
+    free(io);
+
+    return ESP_OK;
+}
+
+static host_panel_io_t *host_io_from_handle(esp_lcd_panel_io_handle_t panel_io)
+{
+    if (panel_io == NULL || panel_io->tx_param != host_io_tx_param)
+    {
+        return NULL;
+    }
+
+    return __containerof(panel_io, host_panel_io_t, base);
+}
+
+// Bus dependent part of a new panel IO
+typedef struct
+{
+    uint64_t pclk_hz;
+    int bits_per_clock;
+    int cmd_bits_per_clock;
+    bool qspi;
+    int lcd_cmd_bits;
+    size_t trans_queue_depth;
+    bool swap_color_bytes;
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    void *user_ctx;
+} host_io_config_t;
+
+// Takes ownership of io, which has its bus attached already, and frees it on failure
+static esp_err_t host_io_new(host_panel_io_t *io, const host_io_config_t *config, esp_lcd_panel_io_handle_t *ret_io)
+{
+    io->pclk_hz = (uint64_t) esp_host_env_int("LVGL_ESP32_HOST_PCLK_HZ", config->pclk_hz);
+    io->bits_per_clock = config->bits_per_clock;
+    io->cmd_bits_per_clock = config->cmd_bits_per_clock;
+    io->qspi = config->qspi;
+    io->cmd_bytes = (config->lcd_cmd_bits + 7) / 8;
+    io->overhead_ns = esp_host_env_int("LVGL_ESP32_HOST_TRANS_OVERHEAD_NS", 0);
+    io->swap_color_bytes = config->swap_color_bytes;
+    int64_t refresh_hz = esp_host_env_int("LVGL_ESP32_HOST_REFRESH_HZ", 60);
+    io->refresh_period_ns = 1000000000LL / (refresh_hz > 0 ? refresh_hz : 60);
+
+    io->on_color_trans_done = config->on_color_trans_done;
+    io->user_ctx = config->user_ctx;
+
+    io->queue_depth = config->trans_queue_depth > 0 ? config->trans_queue_depth : 1;
+    io->queue = calloc(io->queue_depth, sizeof(host_trans_t));
+    if (io->queue == NULL)
+    {
+        host_io_detach(io);
+        free(io);
+        return ESP_ERR_NO_MEM;
+    }
+
+    controller_reset(io);
+
+    pthread_mutex_init(&io->lock, NULL);
+    pthread_cond_init(&io->cond, NULL);
+    if (pthread_create(&io->worker, NULL, host_io_worker, io) != 0)
+    {
+        pthread_cond_destroy(&io->cond);
+        pthread_mutex_destroy(&io->lock);
+        host_io_detach(io);
+        free(io->queue);
+        free(io);
+        return ESP_FAIL;
+    }
+
+    if (pthread_create(&io->scanout, NULL, host_io_scanout, io) != 0)
+    {
+        pthread_mutex_lock(&io->lock);
+        io->stopping = true;
+        pthread_cond_broadcast(&io->cond);
+        pthread_mutex_unlock(&io->lock);
+        pthread_join(io->worker, NULL);
+        pthread_cond_destroy(&io->cond);
+        pthread_mutex_destroy(&io->lock);
+        host_io_detach(io);
+        free(io->queue);
+        free(io);
+        return ESP_FAIL;
+    }
+
+    io->base.rx_param = host_io_rx_param;
+    io->base.tx_param = host_io_tx_param;
+    io->base.tx_color = host_io_tx_color;
+    io->base.del = host_io_del;
+    io->base.register_event_callbacks = host_io_register_event_callbacks;
+
+    *ret_io = &io->base;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_io_spi(
+    esp_lcd_spi_bus_handle_t bus,
+    const esp_lcd_panel_io_spi_config_t *io_config,
+    esp_lcd_panel_io_handle_t *ret_io
+)
+{
+    if (io_config == NULL || ret_io == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    host_panel_io_t *io = calloc(1, sizeof(host_panel_io_t));
+    if (io == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = esp_host_spi_bus_attach((spi_host_device_t) bus, &io->max_transfer_bytes);
+    if (ret != ESP_OK)
+    {
+        free(io);
+        return ret;
+    }
+    io->spi_host = (spi_host_device_t) bus;
+
+    host_io_config_t config = {
+        .pclk_hz = io_config->pclk_hz,
+        .bits_per_clock = io_config->flags.quad_mode ? 4 : 1,
+        .cmd_bits_per_clock = 1,
+        .qspi = io_config->flags.quad_mode,
+        .lcd_cmd_bits = io_config->lcd_cmd_bits,
+        .trans_queue_depth = io_config->trans_queue_depth,
+        .swap_color_bytes = false,
+        .on_color_trans_done = io_config->on_color_trans_done,
+        .user_ctx = io_config->user_ctx,
+    };
+
+    ret = host_io_new(io, &config, ret_io);
+    if (ret == ESP_OK)
+    {
+        ESP_LOGI(
+            TAG,
+            "New %s panel IO on host %d at %llu Hz",
+            io->qspi ? "QSPI" : "SPI",
+            bus,
+            (unsigned long long) io->pclk_hz
+        );
+    }
+
+    return ret;
+}
+
+esp_err_t esp_lcd_new_i80_bus(const esp_lcd_i80_bus_config_t *bus_config, esp_lcd_i80_bus_handle_t *ret_bus)
+{
+    if (bus_config == NULL || ret_bus == NULL || (bus_config->bus_width != 8 && bus_config->bus_width != 16))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_lcd_i80_bus_handle_t bus = calloc(1, sizeof(struct esp_lcd_i80_bus_t));
+    if (bus == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    bus->bus_width = bus_config->bus_width;
+    bus->max_transfer_bytes = bus_config->max_transfer_bytes > 0
+        ? bus_config->max_transfer_bytes
+        : I80_DEFAULT_MAX_TRANSFER_BYTES;
+
+    ESP_LOGI(TAG, "New %d-bit i80 bus", bus->bus_width);
+
+    *ret_bus = bus;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_del_i80_bus(esp_lcd_i80_bus_handle_t bus)
+{
+    if (bus == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (bus->device_count > 0)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    free(bus);
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_io_i80(
+    esp_lcd_i80_bus_handle_t bus,
+    const esp_lcd_panel_io_i80_config_t *io_config,
+    esp_lcd_panel_io_handle_t *ret_io
+)
+{
+    if (bus == NULL || io_config == NULL || ret_io == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    host_panel_io_t *io = calloc(1, sizeof(host_panel_io_t));
+    if (io == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    bus->device_count++;
+    io->i80_bus = bus;
+    io->max_transfer_bytes = bus->max_transfer_bytes;
+
+    host_io_config_t config = {
+        .pclk_hz = io_config->pclk_hz,
+        .bits_per_clock = bus->bus_width,
+        .cmd_bits_per_clock = bus->bus_width,
+        .qspi = false,
+        .lcd_cmd_bits = io_config->lcd_cmd_bits,
+        .trans_queue_depth = io_config->trans_queue_depth,
+        .swap_color_bytes = io_config->flags.swap_color_bytes,
+        .on_color_trans_done = io_config->on_color_trans_done,
+        .user_ctx = io_config->user_ctx,
+    };
+
+    esp_err_t ret = host_io_new(io, &config, ret_io);
+    if (ret == ESP_OK)
+    {
+        ESP_LOGI(TAG, "New i80 panel IO at %llu Hz", (unsigned long long) io->pclk_hz);
+    }
+
+    return ret;
+}
+
+esp_err_t esp_lcd_panel_io_rx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, void *param, size_t param_size)
+{
+    return io == NULL ? ESP_ERR_INVALID_ARG : io->rx_param(io, lcd_cmd, param, param_size);
+}
+
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *param, size_t param_size)
+{
+    return io == NULL ? ESP_ERR_INVALID_ARG : io->tx_param(io, lcd_cmd, param, param_size);
+}
+
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *color, size_t color_size)
+{
+    return io == NULL ? ESP_ERR_INVALID_ARG : io->tx_color(io, lcd_cmd, color, color_size);
+}
+
+esp_err_t esp_lcd_panel_io_register_event_callbacks(
+    esp_lcd_panel_io_handle_t io,
+    const esp_lcd_panel_io_callbacks_t *cbs,
+    void *user_ctx
+)
+{
+    return io == NULL || cbs == NULL ? ESP_ERR_INVALID_ARG : io->register_event_callbacks(io, cbs, user_ctx);
+}
+
+esp_err_t esp_lcd_panel_io_del(esp_lcd_panel_io_handle_t io)
+{
+    return io == NULL ? ESP_ERR_INVALID_ARG : io->del(io);
+}
+
+esp_err_t esp_lcd_host_panel_io_get_stats(esp_lcd_panel_io_handle_t panel_io, esp_lcd_host_stats_t *stats)
+{
+    host_panel_io_t *io = host_io_from_handle(panel_io);
+
+    if (io == NULL || stats == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    stats->transactions = __atomic_load_n(&io->stats.transactions, __ATOMIC_RELAXED);
+    stats->color_transfers = __atomic_load_n(&io->stats.color_transfers, __ATOMIC_RELAXED);
+    stats->commands = __atomic_load_n(&io->stats.commands, __ATOMIC_RELAXED);
+    stats->bytes = __atomic_load_n(&io->stats.bytes, __ATOMIC_RELAXED);
+    stats->pixels = __atomic_load_n(&io->stats.pixels, __ATOMIC_RELAXED);
+    stats->busy_us = __atomic_load_n(&io->stats.busy_us, __ATOMIC_RELAXED);
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_host_panel_io_reset_stats(esp_lcd_panel_io_handle_t panel_io)
+{
+    host_panel_io_t *io = host_io_from_handle(panel_io);
+
+    if (io == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&io->lock);
+    host_io_wait_idle(io);
+    memset(&io->stats, 0, sizeof(io->stats));
+    pthread_mutex_unlock(&io->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_host_panel_io_snapshot(esp_lcd_panel_io_handle_t panel_io, uint16_t *pixels)
+{
+    host_panel_io_t *io = host_io_from_handle(panel_io);
+
+    if (io == NULL || pixels == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&io->lock);
+    host_io_wait_idle(io);
+
+    for (int y = 0; y < GRAM_HEIGHT; y++)
+    {
+        int source = y;
+
+        // Lines inside the vertical scrolling area are read starting from the line set by VSCSAD
+        if (io->scroll_height > 0 && y >= io->scroll_top && y < io->scroll_top + io->scroll_height)
+        {
+            int offset = ((int) io->scroll_start - io->scroll_top) % io->scroll_height;
+            if (offset < 0)
+            {
+                offset += io->scroll_height;
+            }
+            source = io->scroll_top + (y - io->scroll_top + offset) % io->scroll_height;
+        }
+
+        for (int x = 0; x < GRAM_WIDTH; x++)
+        {
+            uint16_t value = source < GRAM_HEIGHT ? io->gram[source * GRAM_WIDTH + x] : 0;
+
+            if (!io->display_on || io->sleeping)
+            {
+                value = 0;
+            }
+            else if (io->inverted)
+            {
+                value = ~value;
+            }
+
+            pixels[y * GRAM_WIDTH + x] = value;
+        }
+    }
+
+    pthread_mutex_unlock(&io->lock);
+
+    return ESP_OK;
+}
+
+static esp_err_t host_st7789_reset(esp_lcd_panel_t *panel)
+{
+    host_st7789_panel_t *st7789 = __containerof(panel, host_st7789_panel_t, base);
+
+    // There is no reset line on the host, a software reset has the same effect on the emulated controller
+    return esp_lcd_panel_io_tx_param(st7789->io, LCD_CMD_SWRESET, NULL, 0);
+}
+
+static esp_err_t host_st7789_init(esp_lcd_panel_t *panel)
+{
+    host_st7789_panel_t *st7789 = __containerof(panel, host_st7789_panel_t, base);
+    esp_lcd_panel_io_handle_t io = st7789->io;
+
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, NULL, 0);
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, (uint8_t[]) { st7789->madctl_val }, 1);
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_COLMOD, (uint8_t[]) { st7789->colmod_val }, 1);
+
+    return esp_lcd_panel_io_tx_param(
+        io,
+        ST7789_CMD_RAMCTRL,
+        (uint8_t[]) { st7789->ramctl_val_1, st7789->ramctl_val_2 },
+        2
+    );
+}
+
+static esp_err_t host_st7789_del(esp_lcd_panel_t *panel)
+{
+    host_st7789_panel_t *st7789 = __containerof(panel, host_st7789_panel_t, base);
+
+    free(st7789);
+
+    return ESP_OK;
+}
+
+static esp_err_t host_st7789_draw_bitmap(
+    esp_lcd_panel_t *panel,
+    int x_start,
+    int y_start,
+    int x_end,
+    int y_end,
+    const void *color_data
+)
+{
+    host_st7789_panel_t *st7789 = __containerof(panel, host_st7789_panel_t, base);
+    esp_lcd_panel_io_handle_t io = st7789->io;
+
+    if (x_start >= x_end || y_start >= y_end)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    x_start += st7789->x_gap;
+    x_end += st7789->x_gap;
+    y_start += st7789->y_gap;
+    y_end += st7789->y_gap;
+
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_CASET, (uint8_t[]) {
+        (x_start >> 8) & 0xFF, x_start & 0xFF, ((x_end - 1) >> 8) & 0xFF, (x_end - 1) & 0xFF,
+    }, 4);
+    esp_lcd_panel_io_tx_param(io, LCD_CMD_RASET, (uint8_t[]) {
+        (y_start >> 8) & 0xFF, y_start & 0xFF, ((y_end - 1) >> 8) & 0xFF, (y_end - 1) & 0xFF,
+    }, 4);
+
+    size_t len = (size_t) (x_end - x_start) * (y_end - y_start) * st7789->fb_bits_per_pixel / 8;
+    return esp_lcd_panel_io_tx_color(io, LCD_CMD_RAMWR, color_data, len);
+}
+
+static esp_err_t host_st7789_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool mirror_y)
+{
+    host_st7789_panel_t *st7789 = __containerof(panel, host_st7789_panel_t, base);
+
+    st7789->madctl_val &= ~(LCD_CMD_MX_BIT | LCD_CMD_MY_BIT);
+    st7789->madctl_val |= (mirror_x ? LCD_CMD_MX_BIT : 0) | (mirror_y ? LCD_CMD_MY_BIT : 0);
+
+    return esp_lcd_panel_io_tx_param(st7789->io, LCD_CMD_MADCTL, (uint8_t[]) { st7789->madctl_val }, 1);
+}
+
+static esp_err_t host_st7789_swap_xy(esp_lcd_panel_t *panel, bool swap_axes)
+{
+    host_st7789_panel_t *st7789 = __containerof(panel, host_st7789_panel_t, base);
+
+    st7789->madctl_val &= ~LCD_CMD_MV_BIT;
+    st7789->madctl_val |= swap_axes ? LCD_CMD_MV_BIT : 0;
+
+    return esp_lcd_panel_io_tx_param(st7789->io, LCD_CMD_MADCTL, (uint8_t[]) { st7789->madctl_val }, 1);
+}
+
+static esp_err_t host_st7789_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_gap)
+{
+    host_st7789_panel_t *st7789 = __containerof(panel, host_st7789_panel_t, base);
+
+    st7789->x_gap = x_gap;
+    st7789->y_gap = y_gap;
+
+    return ESP_OK;
+}
+
+static esp_err_t host_st7789_invert_color(esp_lcd_panel_t *panel, bool invert_color_data)
+{
+    host_st7789_panel_t *st7789 = __containerof(panel, host_st7789_panel_t, base);
+
+    return esp_lcd_panel_io_tx_param(st7789->io, invert_color_data ? LCD_CMD_INVON : LCD_CMD_INVOFF, NULL, 0);
+}
+
+static esp_err_t host_st7789_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
+{
+    host_st7789_panel_t *st7789 = __containerof(panel, host_st7789_panel_t, base);
+
+    return esp_lcd_panel_io_tx_param(st7789->io, on_off ? LCD_CMD_DISPON : LCD_CMD_DISPOFF, NULL, 0);
+}
+
+static esp_err_t host_st7789_disp_sleep(esp_lcd_panel_t *panel, bool sleep)
+{
+    host_st7789_panel_t *st7789 = __containerof(panel, host_st7789_panel_t, base);
+
+    return esp_lcd_panel_io_tx_param(st7789->io, sleep ? LCD_CMD_SLPIN : LCD_CMD_SLPOUT, NULL, 0);
+}
+
+esp_err_t esp_lcd_new_panel_st7789(
+    const esp_lcd_panel_io_handle_t io,
+    const esp_lcd_panel_dev_config_t *panel_dev_config,
+    esp_lcd_panel_handle_t *ret_panel
+)
+{
+    if (io == NULL || panel_dev_config == NULL || ret_panel == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    host_st7789_panel_t *st7789 = calloc(1, sizeof(host_st7789_panel_t));
+    if (st7789 == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    switch (panel_dev_config->bits_per_pixel)
+    {
+        case 16:
+            st7789->colmod_val = 0x55;
+            st7789->fb_bits_per_pixel = 16;
+            break;
+        case 18:
+            st7789->colmod_val = 0x66;
+            st7789->fb_bits_per_pixel = 24;
+            break;
+        default:
+            free(st7789);
+            return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    st7789->io = io;
+    st7789->madctl_val = panel_dev_config->rgb_ele_order == LCD_RGB_ELEMENT_ORDER_BGR ? LCD_CMD_BGR_BIT : 0;
+    st7789->ramctl_val_1 = 0x00;
+    st7789->ramctl_val_2 = 0xF0;
+    if (panel_dev_config->data_endian == LCD_RGB_DATA_ENDIAN_LITTLE)
+    {
+        st7789->ramctl_val_2 |= ST7789_DATA_LITTLE_ENDIAN_BIT;
+    }
+
+    st7789->base.reset = host_st7789_reset;
+    st7789->base.init = host_st7789_init;
+    st7789->base.del = host_st7789_del;
+    st7789->base.draw_bitmap = host_st7789_draw_bitmap;
+    st7789->base.mirror = host_st7789_mirror;
+    st7789->base.swap_xy = host_st7789_swap_xy;
+    st7789->base.set_gap = host_st7789_set_gap;
+    st7789->base.invert_color = host_st7789_invert_color;
+    st7789->base.disp_on_off = host_st7789_disp_on_off;
+    st7789->base.disp_sleep = host_st7789_disp_sleep;
+
+    *ret_panel = &st7789->base;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t panel)
+{
+    return panel == NULL ? ESP_ERR_INVALID_ARG : panel->reset(panel);
+}
+
+esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t panel)
+{
+    return panel == NULL ? ESP_ERR_INVALID_ARG : panel->init(panel);
+}
+
+esp_err_t esp_lcd_panel_del(esp_lcd_panel_handle_t panel)
+{
+    return panel == NULL ? ESP_ERR_INVALID_ARG : panel->del(panel);
+}
+
+esp_err_t esp_lcd_panel_draw_bitmap(
+    esp_lcd_panel_handle_t panel,
+    int x_start,
+    int y_start,
+    int x_end,
+    int y_end,
+    const void *color_data
+)
+{
+    return panel == NULL ? ESP_ERR_INVALID_ARG : panel->draw_bitmap(panel, x_start, y_start, x_end, y_end, color_data);
+}
+
+esp_err_t esp_lcd_panel_mirror(esp_lcd_panel_handle_t panel, bool mirror_x, bool mirror_y)
+{
+    return panel == NULL ? ESP_ERR_INVALID_ARG : panel->mirror(panel, mirror_x, mirror_y);
+}
+
+esp_err_t esp_lcd_panel_swap_xy(esp_lcd_panel_handle_t panel, bool swap_axes)
+{
+    return panel == NULL ? ESP_ERR_INVALID_ARG : panel->swap_xy(panel, swap_axes);
+}
+
+esp_err_t esp_lcd_panel_set_gap(esp_lcd_panel_handle_t panel, int x_gap, int y_gap)
+{
+    return panel == NULL ? ESP_ERR_INVALID_ARG : panel->set_gap(panel, x_gap, y_gap);
+}
+
+esp_err_t esp_lcd_panel_invert_color(esp_lcd_panel_handle_t panel, bool invert_color_data)
+{
+    return panel == NULL ? ESP_ERR_INVALID_ARG : panel->invert_color(panel, invert_color_data);
+}
+
+esp_err_t esp_lcd_panel_disp_on_off(esp_lcd_panel_handle_t panel, bool on_off)
+{
+    return panel == NULL ? ESP_ERR_INVALID_ARG : panel->disp_on_off(panel, on_off);
+}
+
+esp_err_t esp_lcd_panel_disp_sleep(esp_lcd_panel_handle_t panel, bool sleep)
+{
+    return panel == NULL ? ESP_ERR_INVALID_ARG : panel->disp_sleep(panel, sleep);
+}
@@ -0,0 +1,31 @@
+#ifndef __LVGL_ESP32_HOST_DRIVER_SPI_MASTER_H__
+#define __LVGL_ESP32_HOST_DRIVER_SPI_MASTER_H__
+
+#include "esp_err.h"
+#include "hal/spi_types.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum
+{
+    SPI_DMA_DISABLED = 0,
+    SPI_DMA_CH_AUTO = 3,
+} spi_dma_chan_t;
+
+typedef struct
+{
+    int mosi_io_num;
+    int miso_io_num;
+    int sclk_io_num;
+    int quadwp_io_num;
+    int quadhd_io_num;
+    int max_transfer_sz;
+    uint32_t flags;
+} spi_bus_config_t;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t *bus_config, spi_dma_chan_t dma_chan);
+esp_err_t spi_bus_free(spi_host_device_t host_id);
+esp_err_t spi_bus_get_max_transaction_len(spi_host_device_t host_id, size_t *max_bytes);
+
+#endif /* __LVGL_ESP32_HOST_DRIVER_SPI_MASTER_H__ */
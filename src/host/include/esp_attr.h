@@ -0,0 +1,7 @@
+#ifndef __LVGL_ESP32_HOST_ESP_ATTR_H__
+#define __LVGL_ESP32_HOST_ESP_ATTR_H__
+
+// There is no instruction RAM on the host
+#define IRAM_ATTR
+
+#endif /* __LVGL_ESP32_HOST_ESP_ATTR_H__ */
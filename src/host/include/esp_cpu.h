@@ -0,0 +1,17 @@
+#ifndef __LVGL_ESP32_HOST_ESP_CPU_H__
+#define __LVGL_ESP32_HOST_ESP_CPU_H__
+
+#include <stdint.h>
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+// There is no portable cycle counter on the host, nanoseconds on CLOCK_MONOTONIC are used instead
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void);
+
+// Everything is reported as running on the first core
+static inline int esp_cpu_get_core_id(void)
+{
+    return 0;
+}
+
+#endif /* __LVGL_ESP32_HOST_ESP_CPU_H__ */
@@ -0,0 +1,29 @@
+#ifndef __LVGL_ESP32_HOST_ESP_LCD_HOST_H__
+#define __LVGL_ESP32_HOST_ESP_LCD_HOST_H__
+
+// Host-only inspection API of the esp_lcd stand-in, not part of ESP-IDF
+
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+
+// Size of the emulated ST7789 graphics RAM in its native (unrotated) orientation
+#define ESP_LCD_HOST_GRAM_WIDTH     240
+#define ESP_LCD_HOST_GRAM_HEIGHT    320
+
+typedef struct
+{
+    uint64_t transactions;      // bus transactions, commands and every color chunk count as one
+    uint64_t color_transfers;   // calls to tx_color
+    uint64_t commands;          // commands sent through tx_param or tx_color
+    uint64_t bytes;             // bytes clocked over the bus, including command bytes
+    uint64_t pixels;            // pixels written into graphics RAM
+    uint64_t busy_us;           // modelled time the bus was busy
+} esp_lcd_host_stats_t;
+
+esp_err_t esp_lcd_host_panel_io_get_stats(esp_lcd_panel_io_handle_t io, esp_lcd_host_stats_t *stats);
+esp_err_t esp_lcd_host_panel_io_reset_stats(esp_lcd_panel_io_handle_t io);
+
+// Copies the image as scanned out to the glass, ESP_LCD_HOST_GRAM_WIDTH x ESP_LCD_HOST_GRAM_HEIGHT RGB565 values
+esp_err_t esp_lcd_host_panel_io_snapshot(esp_lcd_panel_io_handle_t io, uint16_t *pixels);
+
+#endif /* __LVGL_ESP32_HOST_ESP_LCD_HOST_H__ */
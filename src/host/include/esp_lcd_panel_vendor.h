@@ -0,0 +1,30 @@
+#ifndef __LVGL_ESP32_HOST_ESP_LCD_PANEL_VENDOR_H__
+#define __LVGL_ESP32_HOST_ESP_LCD_PANEL_VENDOR_H__
+
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+
+typedef struct
+{
+    int reset_gpio_num;
+    union
+    {
+        lcd_rgb_element_order_t rgb_ele_order;
+        lcd_rgb_element_order_t color_space;
+    };
+    lcd_rgb_data_endian_t data_endian;
+    uint32_t bits_per_pixel;
+    struct
+    {
+        unsigned int reset_active_high: 1;
+    } flags;
+    void *vendor_config;
+} esp_lcd_panel_dev_config_t;
+
+esp_err_t esp_lcd_new_panel_st7789(
+    const esp_lcd_panel_io_handle_t io,
+    const esp_lcd_panel_dev_config_t *panel_dev_config,
+    esp_lcd_panel_handle_t *ret_panel
+);
+
+#endif /* __LVGL_ESP32_HOST_ESP_LCD_PANEL_VENDOR_H__ */
@@ -0,0 +1,23 @@
+#ifndef __LVGL_ESP32_HOST_ESP_LCD_TYPES_H__
+#define __LVGL_ESP32_HOST_ESP_LCD_TYPES_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;
+
+typedef enum
+{
+    LCD_RGB_ELEMENT_ORDER_RGB,
+    LCD_RGB_ELEMENT_ORDER_BGR,
+} lcd_rgb_element_order_t;
+
+typedef enum
+{
+    LCD_RGB_DATA_ENDIAN_BIG = 0,
+    LCD_RGB_DATA_ENDIAN_LITTLE,
+} lcd_rgb_data_endian_t;
+
+#endif /* __LVGL_ESP32_HOST_ESP_LCD_TYPES_H__ */
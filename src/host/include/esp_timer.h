@@ -0,0 +1,9 @@
+#ifndef __LVGL_ESP32_HOST_ESP_TIMER_H__
+#define __LVGL_ESP32_HOST_ESP_TIMER_H__
+
+#include <stdint.h>
+
+// Microseconds since the first call, based on CLOCK_MONOTONIC
+int64_t esp_timer_get_time(void);
+
+#endif /* __LVGL_ESP32_HOST_ESP_TIMER_H__ */
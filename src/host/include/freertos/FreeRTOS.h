@@ -0,0 +1,38 @@
+#ifndef __LVGL_ESP32_HOST_FREERTOS_H__
+#define __LVGL_ESP32_HOST_FREERTOS_H__
+
+#include <stdint.h>
+
+#include "esp_heap_caps.h"
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE                 ((BaseType_t) 0)
+#define pdTRUE                  ((BaseType_t) 1)
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+
+// The host runs at a 1 kHz tick
+#define configTICK_RATE_HZ      1000
+#define portTICK_PERIOD_MS      ((TickType_t) 1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY           ((TickType_t) 0xffffffffUL)
+#define pdMS_TO_TICKS(ms)       ((TickType_t) (((TickType_t) (ms) * (TickType_t) configTICK_RATE_HZ) / (TickType_t) 1000U))
+
+// Interrupts are emulated by threads, which have no need to yield
+#define portYIELD_FROM_ISR(x)   ((void) (x))
+
+// Those threads may block like tasks do, so nothing counts as being in an interrupt
+static inline BaseType_t xPortInIsrContext(void)
+{
+    return pdFALSE;
+}
+
+// Tasks are not pinned on the host, everything claims to run on the first core
+static inline BaseType_t xPortGetCoreID(void)
+{
+    return 0;
+}
+
+#endif /* __LVGL_ESP32_HOST_FREERTOS_H__ */
@@ -0,0 +1,15 @@
+#ifndef __LVGL_ESP32_HOST_FREERTOS_SEMPHR_H__
+#define __LVGL_ESP32_HOST_FREERTOS_SEMPHR_H__
+
+#include "freertos/FreeRTOS.h"
+
+// Binary semaphores backed by a POSIX mutex and condition variable
+typedef struct host_semaphore_t *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t *higher_priority_task_woken);
+
+#endif /* __LVGL_ESP32_HOST_FREERTOS_SEMPHR_H__ */
@@ -0,0 +1,30 @@
+#ifndef __LVGL_ESP32_HOST_FREERTOS_TASK_H__
+#define __LVGL_ESP32_HOST_FREERTOS_TASK_H__
+
+#include "freertos/FreeRTOS.h"
+
+// Tasks are backed by detached POSIX threads, priorities and core affinity are ignored
+typedef struct host_task_t *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define tskIDLE_PRIORITY        ((UBaseType_t) 0U)
+#define tskNO_AFFINITY          ((BaseType_t) 0x7FFFFFFF)
+
+BaseType_t xTaskCreatePinnedToCore(
+    TaskFunction_t task_code,
+    const char *name,
+    const uint32_t stack_depth,
+    void *parameters,
+    UBaseType_t priority,
+    TaskHandle_t *created_task,
+    const BaseType_t core_id
+);
+
+// Only deleting the calling task (NULL) is supported
+void vTaskDelete(TaskHandle_t task);
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+void vTaskDelay(const TickType_t ticks);
+
+#endif /* __LVGL_ESP32_HOST_FREERTOS_TASK_H__ */
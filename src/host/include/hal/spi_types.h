@@ -0,0 +1,12 @@
+#ifndef __LVGL_ESP32_HOST_HAL_SPI_TYPES_H__
+#define __LVGL_ESP32_HOST_HAL_SPI_TYPES_H__
+
+typedef enum
+{
+    SPI1_HOST = 0,
+    SPI2_HOST = 1,
+    SPI3_HOST = 2,
+    SPI_HOST_MAX,
+} spi_host_device_t;
+
+#endif /* __LVGL_ESP32_HOST_HAL_SPI_TYPES_H__ */
@@ -0,0 +1,6 @@
+#ifndef __LVGL_ESP32_HOST_SDKCONFIG_H__
+#define __LVGL_ESP32_HOST_SDKCONFIG_H__
+
+// The host is not an ESP32 target, none of the CONFIG_IDF_TARGET_* options are set
+
+#endif /* __LVGL_ESP32_HOST_SDKCONFIG_H__ */
@@ -0,0 +1,175 @@
+#include "i80.h"
+#include "auto.h"
+
+#include "py/runtime.h"
+
+#include "esp_err.h"
+#include "esp_log.h"
+
+static const char *TAG = "lvgl_esp32_i80";
+
+// Transfer size until the Wrapper has a plan for AUTO, a 320x240 frame
+#define DEFAULT_MAX_TRANSFER_BYTES (320 * 240 * 2)
+
+static mp_obj_t lvgl_esp32_I80_init(mp_obj_t self_ptr)
+{
+    struct lvgl_esp32_I80_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    ESP_LOGI(TAG, "Initializing %d-bit i80 Bus", self->bus_width);
+    esp_lcd_i80_bus_config_t bus_config = {
+        .dc_gpio_num = self->dc,
+        .wr_gpio_num = self->wr,
+        .clk_src = LCD_CLK_SRC_DEFAULT,
+        .bus_width = self->bus_width,
+        .max_transfer_bytes = self->max_transfer_bytes,
+    };
+
+    for (int i = 0; i < self->bus_width; i++)
+    {
+        bus_config.data_gpio_nums[i] = self->data[i];
+    }
+
+    ESP_ERROR_CHECK(esp_lcd_new_i80_bus(&bus_config, &self->bus_handle));
+    self->bus_initialized = true;
+
+    return mp_obj_new_int_from_uint(0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_I80_init_obj, lvgl_esp32_I80_init);
+
+static mp_obj_t lvgl_esp32_I80_deinit(mp_obj_t self_ptr)
+{
+    struct lvgl_esp32_I80_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    if (self->bus_initialized)
+    {
+        ESP_LOGI(TAG, "Deinitializing i80 Bus");
+
+        // HACK
+        if (self->device_count > 0)
+        {
+            ESP_LOGW(TAG, "Could not deinitialize i80 Bus (yet), still active devices");
+            self->needs_deinit = true;
+            return mp_obj_new_int_from_uint(0);
+        }
+
+        ESP_ERROR_CHECK(esp_lcd_del_i80_bus(self->bus_handle));
+        self->bus_handle = NULL;
+        self->bus_initialized = false;
+        self->needs_deinit = false;
+    }
+
+    return mp_obj_new_int_from_uint(0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_I80_deinit_obj, lvgl_esp32_I80_deinit);
+
+void lvgl_esp32_I80_internal_deinit(lvgl_esp32_I80_obj_t *self)
+{
+    if (self->needs_deinit)
+    {
+        lvgl_esp32_I80_deinit(self);
+    }
+}
+
+bool lvgl_esp32_I80_set_max_transfer_bytes(lvgl_esp32_I80_obj_t *self, size_t max_transfer_bytes)
+{
+    if (self->max_transfer_bytes == max_transfer_bytes)
+    {
+        return true;
+    }
+
+    if (!self->bus_initialized)
+    {
+        self->max_transfer_bytes = max_transfer_bytes;
+        return true;
+    }
+
+    // HACK
+    if (self->device_count > 0)
+    {
+        ESP_LOGW(TAG, "Could not change the transfer size of the i80 Bus, still active devices");
+        return false;
+    }
+
+    lvgl_esp32_I80_deinit(MP_OBJ_FROM_PTR(self));
+    self->max_transfer_bytes = max_transfer_bytes;
+    lvgl_esp32_I80_init(MP_OBJ_FROM_PTR(self));
+
+    return true;
+}
+
+static mp_obj_t lvgl_esp32_I80_make_new(
+    const mp_obj_type_t *type,
+    size_t n_args,
+    size_t n_kw,
+    const mp_obj_t *all_args
+)
+{
+    enum
+    {
+        ARG_data,                   // data pins, 8 or 16 of them
+        ARG_dc,                     // DC pin
+        ARG_wr,                     // WR pin, which clocks the data
+        ARG_max_transfer_bytes,     // largest color transfer the bus accepts, or AUTO
+    };
+
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_data, MP_ARG_OBJ | MP_ARG_REQUIRED },
+        { MP_QSTR_dc, MP_ARG_INT | MP_ARG_REQUIRED },
+        { MP_QSTR_wr, MP_ARG_INT | MP_ARG_REQUIRED },
+        { MP_QSTR_max_transfer_bytes, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = DEFAULT_MAX_TRANSFER_BYTES }},
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    size_t data_len;
+    mp_obj_t *data;
+    mp_obj_get_array(args[ARG_data].u_obj, &data_len, &data);
+
+    if (data_len != 8 && data_len != 16)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("i80 bus needs 8 or 16 data pins"));
+    }
+
+    if (args[ARG_max_transfer_bytes].u_int <= 0 && args[ARG_max_transfer_bytes].u_int != LVGL_ESP32_AUTO)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid max_transfer_bytes"));
+    }
+
+    struct lvgl_esp32_I80_obj_t *self = mp_obj_malloc_with_finaliser(lvgl_esp32_I80_obj_t, &lvgl_esp32_I80_type);
+
+    self->bus_width = data_len;
+    for (size_t i = 0; i < data_len; i++)
+    {
+        self->data[i] = mp_obj_get_int(data[i]);
+    }
+    self->dc = args[ARG_dc].u_int;
+    self->wr = args[ARG_wr].u_int;
+    self->auto_transfer = args[ARG_max_transfer_bytes].u_int == LVGL_ESP32_AUTO;
+    self->max_transfer_bytes = self->auto_transfer ? DEFAULT_MAX_TRANSFER_BYTES : args[ARG_max_transfer_bytes].u_int;
+
+    self->bus_handle = NULL;
+    self->bus_initialized = false;
+    self->needs_deinit = false;
+    self->device_count = 0;
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+static const mp_rom_map_elem_t lvgl_esp32_I80_locals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_init), MP_ROM_PTR(&lvgl_esp32_I80_init_obj) },
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&lvgl_esp32_I80_deinit_obj) },
+    { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&lvgl_esp32_I80_deinit_obj) },
+};
+
+static MP_DEFINE_CONST_DICT(lvgl_esp32_I80_locals, lvgl_esp32_I80_locals_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    lvgl_esp32_I80_type,
+    MP_QSTR_I80,
+    MP_TYPE_FLAG_NONE,
+    make_new,
+    lvgl_esp32_I80_make_new,
+    locals_dict,
+    &lvgl_esp32_I80_locals
+);
@@ -0,0 +1,40 @@
+#ifndef __LVGL_ESP32_I80_H__
+#define __LVGL_ESP32_I80_H__
+
+#include "py/obj.h"
+
+#include "esp_lcd_panel_io.h"
+
+// Widest bus supported by the i80 peripheral
+#define LVGL_ESP32_I80_MAX_BUS_WIDTH 16
+
+typedef struct lvgl_esp32_I80_obj_t
+{
+    mp_obj_base_t base;
+
+    esp_lcd_i80_bus_handle_t bus_handle;
+
+    // With auto_transfer the Wrapper sets max_transfer_bytes to fit its draw buffers
+    size_t max_transfer_bytes;
+    bool auto_transfer;
+
+    uint8_t bus_width;
+    uint8_t data[LVGL_ESP32_I80_MAX_BUS_WIDTH];
+    uint8_t dc;
+    uint8_t wr;
+
+    bool bus_initialized;
+    bool needs_deinit;
+
+    // Same approach as lvgl_esp32_SPI_obj_t, the bus can only be deleted once the panel IO using it is gone
+    uint8_t device_count;
+} lvgl_esp32_I80_obj_t;
+
+void lvgl_esp32_I80_internal_deinit(lvgl_esp32_I80_obj_t *self);
+
+// Same as lvgl_esp32_SPI_set_max_transfer_bytes()
+bool lvgl_esp32_I80_set_max_transfer_bytes(lvgl_esp32_I80_obj_t *self, size_t max_transfer_bytes);
+
+extern const mp_obj_type_t lvgl_esp32_I80_type;
+
+#endif /* __LVGL_ESP32_I80_H__ */
@@ -1,12 +1,19 @@
+#include "auto.h"
 #include "display.h"
 #include "wrapper.h"
+#include "i80.h"
 #include "spi.h"
+#include "swap.h"
 
 static const mp_rom_map_elem_t lvgl_esp32_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_lvgl_esp32) },
     { MP_ROM_QSTR(MP_QSTR_SPI), MP_ROM_PTR(&lvgl_esp32_SPI_type) },
+    { MP_ROM_QSTR(MP_QSTR_I80), MP_ROM_PTR(&lvgl_esp32_I80_type) },
     { MP_ROM_QSTR(MP_QSTR_Display), MP_ROM_PTR(&lvgl_esp32_Display_type) },
     { MP_ROM_QSTR(MP_QSTR_Wrapper), MP_ROM_PTR(&lvgl_esp32_Wrapper_type) },
+    { MP_ROM_QSTR(MP_QSTR_benchmark_swap), MP_ROM_PTR(&lvgl_esp32_benchmark_swap_obj) },
+    { MP_ROM_QSTR(MP_QSTR_DRAW_UNITS), MP_ROM_INT(LV_DRAW_SW_DRAW_UNIT_CNT) },
+    { MP_ROM_QSTR(MP_QSTR_AUTO), MP_ROM_INT(LVGL_ESP32_AUTO) },
 };
 static MP_DEFINE_CONST_DICT(lvgl_esp32_globals, lvgl_esp32_globals_table);
 
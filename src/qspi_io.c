@@ -0,0 +1,95 @@
+#include "qspi_io.h"
+
+#include "esp_heap_caps.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_io_interface.h"
+
+#include <stddef.h>
+
+// Opcodes of the command phase
+#define QSPI_OPCODE_READ            0x03    // single line
+#define QSPI_OPCODE_WRITE           0x02    // single line, used for parameters
+#define QSPI_OPCODE_WRITE_COLOR     0x32    // address on one line, data on four
+
+#ifndef __containerof
+#define __containerof(ptr, type, member) ((type *) ((char *) (ptr) - offsetof(type, member)))
+#endif
+
+typedef struct
+{
+    esp_lcd_panel_io_t base;
+    esp_lcd_panel_io_handle_t spi_io;
+} qspi_panel_io_t;
+
+static int frame(uint8_t opcode, int lcd_cmd)
+{
+    // Negative commands mean there is no command phase at all
+    return lcd_cmd < 0 ? lcd_cmd : (opcode << 24) | ((lcd_cmd & 0xFF) << 8);
+}
+
+static esp_err_t qspi_rx_param(esp_lcd_panel_io_t *io, int lcd_cmd, void *param, size_t param_size)
+{
+    qspi_panel_io_t *qspi = __containerof(io, qspi_panel_io_t, base);
+
+    return esp_lcd_panel_io_rx_param(qspi->spi_io, frame(QSPI_OPCODE_READ, lcd_cmd), param, param_size);
+}
+
+static esp_err_t qspi_tx_param(esp_lcd_panel_io_t *io, int lcd_cmd, const void *param, size_t param_size)
+{
+    qspi_panel_io_t *qspi = __containerof(io, qspi_panel_io_t, base);
+
+    return esp_lcd_panel_io_tx_param(qspi->spi_io, frame(QSPI_OPCODE_WRITE, lcd_cmd), param, param_size);
+}
+
+static esp_err_t qspi_tx_color(esp_lcd_panel_io_t *io, int lcd_cmd, const void *color, size_t color_size)
+{
+    qspi_panel_io_t *qspi = __containerof(io, qspi_panel_io_t, base);
+
+    return esp_lcd_panel_io_tx_color(qspi->spi_io, frame(QSPI_OPCODE_WRITE_COLOR, lcd_cmd), color, color_size);
+}
+
+static esp_err_t qspi_del(esp_lcd_panel_io_t *io)
+{
+    qspi_panel_io_t *qspi = __containerof(io, qspi_panel_io_t, base);
+
+    esp_err_t ret = esp_lcd_panel_io_del(qspi->spi_io);
+    heap_caps_free(qspi);
+
+    return ret;
+}
+
+static esp_err_t qspi_register_event_callbacks(
+    esp_lcd_panel_io_t *io,
+    const esp_lcd_panel_io_callbacks_t *cbs,
+    void *user_ctx
+)
+{
+    qspi_panel_io_t *qspi = __containerof(io, qspi_panel_io_t, base);
+
+    return esp_lcd_panel_io_register_event_callbacks(qspi->spi_io, cbs, user_ctx);
+}
+
+esp_err_t lvgl_esp32_new_qspi_panel_io(esp_lcd_panel_io_handle_t spi_io, esp_lcd_panel_io_handle_t *ret_io)
+{
+    if (spi_io == NULL || ret_io == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    qspi_panel_io_t *qspi = heap_caps_calloc(1, sizeof(qspi_panel_io_t), MALLOC_CAP_DEFAULT);
+    if (qspi == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    qspi->spi_io = spi_io;
+    qspi->base.rx_param = qspi_rx_param;
+    qspi->base.tx_param = qspi_tx_param;
+    qspi->base.tx_color = qspi_tx_color;
+    qspi->base.del = qspi_del;
+    qspi->base.register_event_callbacks = qspi_register_event_callbacks;
+
+    *ret_io = &qspi->base;
+
+    return ESP_OK;
+}
@@ -0,0 +1,12 @@
+#ifndef __LVGL_ESP32_QSPI_IO_H__
+#define __LVGL_ESP32_QSPI_IO_H__
+
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+
+// QSPI panels take every command as an opcode byte followed by the MIPI DCS command as a 24-bit address. This panel IO
+// adds that framing around an SPI panel IO in quad mode (lcd_cmd_bits = 32), so DCS panel drivers can be used as is.
+// Deleting it deletes the SPI panel IO too.
+esp_err_t lvgl_esp32_new_qspi_panel_io(esp_lcd_panel_io_handle_t spi_io, esp_lcd_panel_io_handle_t *ret_io);
+
+#endif /* __LVGL_ESP32_QSPI_IO_H__ */
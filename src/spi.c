@@ -1,4 +1,5 @@
 #include "spi.h"
+#include "auto.h"
 
 #include "py/runtime.h"
 
@@ -17,8 +18,9 @@ static mp_obj_t lvgl_esp32_SPI_init(mp_obj_t self_ptr)
         .sclk_io_num = self->sck,
         .mosi_io_num = self->mosi,
         .miso_io_num = self->miso,
-        .quadwp_io_num = -1,
-        .quadhd_io_num = -1,
+        .quadwp_io_num = self->data2,
+        .quadhd_io_num = self->data3,
+        .max_transfer_sz = self->max_transfer_bytes,
     };
 
     ESP_ERROR_CHECK(spi_bus_initialize(self->spi_host_device, &bus_config, SPI_DMA_CH_AUTO));
@@ -73,6 +75,33 @@ void lvgl_esp32_SPI_internal_deinit(lvgl_esp32_SPI_obj_t *self)
     }
 }
 
+bool lvgl_esp32_SPI_set_max_transfer_bytes(lvgl_esp32_SPI_obj_t *self, size_t max_transfer_bytes)
+{
+    if (self->max_transfer_bytes == max_transfer_bytes)
+    {
+        return true;
+    }
+
+    if (!self->bus_initialized)
+    {
+        self->max_transfer_bytes = max_transfer_bytes;
+        return true;
+    }
+
+    // HACK
+    if (self->device_count > 0)
+    {
+        ESP_LOGW(TAG, "Could not change the transfer size of the SPI Bus, still active devices");
+        return false;
+    }
+
+    lvgl_esp32_SPI_deinit(MP_OBJ_FROM_PTR(self));
+    self->max_transfer_bytes = max_transfer_bytes;
+    lvgl_esp32_SPI_init(MP_OBJ_FROM_PTR(self));
+
+    return true;
+}
+
 static mp_obj_t lvgl_esp32_SPI_make_new(
     const mp_obj_type_t *type,
     size_t n_args,
@@ -82,11 +111,14 @@ static mp_obj_t lvgl_esp32_SPI_make_new(
 {
     enum
     {
-        ARG_spi_id,         // ID of SPI to use
-        ARG_baudrate,       // Baudrate
-        ARG_sck,            // SCK pin
-        ARG_mosi,           // MOSI pin
-        ARG_miso,           // MISO pin
+        ARG_spi_id,                 // ID of SPI to use
+        ARG_baudrate,               // Baudrate
+        ARG_sck,                    // SCK pin
+        ARG_mosi,                   // MOSI pin
+        ARG_miso,                   // MISO pin, data1 in quad mode
+        ARG_data2,                  // data2 (WP) pin for quad mode
+        ARG_data3,                  // data3 (HD) pin for quad mode
+        ARG_max_transfer_bytes,     // largest transaction, 0 for the driver default or AUTO
     };
 
     static const mp_arg_t allowed_args[] = {
@@ -95,11 +127,21 @@ static mp_obj_t lvgl_esp32_SPI_make_new(
         { MP_QSTR_sck, MP_ARG_INT | MP_ARG_REQUIRED },
         { MP_QSTR_mosi, MP_ARG_INT | MP_ARG_REQUIRED },
         { MP_QSTR_miso, MP_ARG_INT | MP_ARG_REQUIRED },
+        { MP_QSTR_data2, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = -1 }},
+        { MP_QSTR_data3, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = -1 }},
+        { MP_QSTR_max_transfer_bytes, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 0 }},
     };
 
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
     mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
+    mp_int_t max_transfer_bytes = args[ARG_max_transfer_bytes].u_int;
+    if (max_transfer_bytes > LVGL_ESP32_SPI_MAX_TRANSFER_BYTES
+        || (max_transfer_bytes < 0 && max_transfer_bytes != LVGL_ESP32_AUTO))
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid max_transfer_bytes"));
+    }
+
     struct lvgl_esp32_SPI_obj_t *self = mp_obj_malloc_with_finaliser(lvgl_esp32_SPI_obj_t, &lvgl_esp32_SPI_type);
 
     switch (args[ARG_spi_id].u_int)
@@ -119,6 +161,12 @@ static mp_obj_t lvgl_esp32_SPI_make_new(
     self->sck = args[ARG_sck].u_int;
     self->mosi = args[ARG_mosi].u_int;
     self->miso = args[ARG_miso].u_int;
+    self->data2 = args[ARG_data2].u_int;
+    self->data3 = args[ARG_data3].u_int;
+
+    // Until the Wrapper has a plan, AUTO uses the driver default
+    self->auto_transfer = max_transfer_bytes == LVGL_ESP32_AUTO;
+    self->max_transfer_bytes = self->auto_transfer ? 0 : max_transfer_bytes;
 
     self->bus_initialized = false;
     self->needs_deinit = false;
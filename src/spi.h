@@ -5,6 +5,11 @@
 
 #include "hal/spi_types.h"
 
+#include <stddef.h>
+
+// Largest DMA transaction of the SPI peripheral on the ESP32-S3 and C3 (2^18 bits)
+#define LVGL_ESP32_SPI_MAX_TRANSFER_BYTES (32 * 1024)
+
 typedef struct lvgl_esp32_SPI_obj_t
 {
     mp_obj_base_t base;
@@ -16,6 +21,14 @@ typedef struct lvgl_esp32_SPI_obj_t
     uint8_t mosi;
     uint8_t miso;
 
+    // Extra data lines for quad mode, -1 when not connected
+    int8_t data2;
+    int8_t data3;
+
+    // Largest transaction, 0 for the driver default. With auto_transfer the Wrapper sets it to fit its draw buffers.
+    size_t max_transfer_bytes;
+    bool auto_transfer;
+
     bool bus_initialized;
     bool needs_deinit;
 
@@ -27,6 +40,10 @@ typedef struct lvgl_esp32_SPI_obj_t
 
 void lvgl_esp32_SPI_internal_deinit(lvgl_esp32_SPI_obj_t* self);
 
+// Changes max_transfer_bytes, initializing the bus again when it already is. Returns false when that is not possible
+// because devices are still using it.
+bool lvgl_esp32_SPI_set_max_transfer_bytes(lvgl_esp32_SPI_obj_t *self, size_t max_transfer_bytes);
+
 extern const mp_obj_type_t lvgl_esp32_SPI_type;
 
 #endif /* __LVGL_ESP32_SPI_H__ */
@@ -0,0 +1,283 @@
+#include "swap.h"
+
+#include "py/runtime.h"
+
+#include "lvgl.h"
+#include "sdkconfig.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+
+#include <stdint.h>
+#include <string.h>
+
+// Pixels are accessed as words too, tell the compiler those accesses may alias the uint16_t ones
+typedef uint32_t __attribute__((may_alias)) swap_word_t;
+
+static inline uint32_t swap_word(uint32_t word)
+{
+    return ((word << 8) & 0xFF00FF00) | ((word >> 8) & 0x00FF00FF);
+}
+
+// Reference implementation, one pixel at a time
+static void swap_rgb565_scalar(uint16_t *pixels, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        pixels[i] = __builtin_bswap16(pixels[i]);
+    }
+}
+
+// Portable implementation, two pixels per 32-bit word
+static void swap_rgb565_word(uint16_t *pixels, size_t count)
+{
+    if (count > 0 && ((uintptr_t) pixels & 0x2))
+    {
+        *pixels = __builtin_bswap16(*pixels);
+        pixels++;
+        count--;
+    }
+
+    swap_word_t *words = (swap_word_t *) pixels;
+    size_t word_count = count / 2;
+    size_t i = 0;
+
+    for (; i + 4 <= word_count; i += 4)
+    {
+        words[i] = swap_word(words[i]);
+        words[i + 1] = swap_word(words[i + 1]);
+        words[i + 2] = swap_word(words[i + 2]);
+        words[i + 3] = swap_word(words[i + 3]);
+    }
+
+    for (; i < word_count; i++)
+    {
+        words[i] = swap_word(words[i]);
+    }
+
+    if (count & 1)
+    {
+        pixels[count - 1] = __builtin_bswap16(pixels[count - 1]);
+    }
+}
+
+#if CONFIG_IDF_TARGET_ESP32S3
+// ESP32-S3 implementation, eight pixels per 128-bit PIE register. The vector loads and stores ignore the lower four
+// address bits, so the aligned middle part is handed to the vector loop and the edges to the word implementation.
+static void swap_rgb565_pie(uint16_t *pixels, size_t count)
+{
+    static const uint32_t masks[2] = { 0xFF00FF00, 0x00FF00FF };
+
+    size_t head = ((16 - ((uintptr_t) pixels & 0xF)) & 0xF) / sizeof(uint16_t);
+    if (head > count)
+    {
+        head = count;
+    }
+
+    swap_rgb565_word(pixels, head);
+    pixels += head;
+    count -= head;
+
+    size_t blocks = count / 8;
+    if (blocks > 0)
+    {
+        uint16_t *src = pixels;
+        uint16_t *dst = pixels;
+
+        // Shifting by SAR works on each 32-bit lane, the masks then pick the bytes that belong in every position
+        __asm__ volatile(
+            "ee.vldbc.32 q6, %[high]\n"
+            "ee.vldbc.32 q7, %[low]\n"
+            "ssai 8\n"
+            "1:\n"
+            "ee.vld.128.ip q0, %[src], 16\n"
+            "ee.vsl.32 q1, q0\n"
+            "ee.vsr.32 q2, q0\n"
+            "ee.andq q1, q1, q6\n"
+            "ee.andq q2, q2, q7\n"
+            "ee.orq q1, q1, q2\n"
+            "ee.vst.128.ip q1, %[dst], 16\n"
+            "addi %[blocks], %[blocks], -1\n"
+            "bnez %[blocks], 1b\n"
+            : [src] "+r" (src), [dst] "+r" (dst), [blocks] "+r" (blocks)
+            : [high] "r" (&masks[0]), [low] "r" (&masks[1])
+            : "memory"
+        );
+
+        pixels += (count / 8) * 8;
+        count %= 8;
+    }
+
+    swap_rgb565_word(pixels, count);
+}
+#endif
+
+void lvgl_esp32_swap_rgb565(void *buf, size_t pixel_count)
+{
+#if CONFIG_IDF_TARGET_ESP32S3
+    swap_rgb565_pie((uint16_t *) buf, pixel_count);
+#else
+    swap_rgb565_word((uint16_t *) buf, pixel_count);
+#endif
+}
+
+// Keeps the upper four bits of every component
+static inline uint32_t rgb565_to_rgb444(uint32_t pixel)
+{
+    return ((pixel >> 4) & 0xF00) | ((pixel >> 3) & 0x0F0) | ((pixel >> 1) & 0x00F);
+}
+
+size_t lvgl_esp32_pack_rgb444(void *buf, size_t pixel_count)
+{
+    const uint16_t *pixels = (const uint16_t *) buf;
+    uint8_t *out = (uint8_t *) buf;
+    size_t i = 0;
+
+    // Every pair is read before its three bytes are written, which never reach the next pair
+    for (; i + 4 <= pixel_count; i += 4)
+    {
+        uint32_t first = rgb565_to_rgb444(pixels[i]) << 12 | rgb565_to_rgb444(pixels[i + 1]);
+        uint32_t second = rgb565_to_rgb444(pixels[i + 2]) << 12 | rgb565_to_rgb444(pixels[i + 3]);
+
+        out[0] = first >> 16;
+        out[1] = first >> 8;
+        out[2] = first;
+        out[3] = second >> 16;
+        out[4] = second >> 8;
+        out[5] = second;
+        out += 6;
+    }
+
+    for (; i + 2 <= pixel_count; i += 2)
+    {
+        uint32_t pair = rgb565_to_rgb444(pixels[i]) << 12 | rgb565_to_rgb444(pixels[i + 1]);
+
+        out[0] = pair >> 16;
+        out[1] = pair >> 8;
+        out[2] = pair;
+        out += 3;
+    }
+
+    if (i < pixel_count)
+    {
+        uint32_t pixel = rgb565_to_rgb444(pixels[i]);
+
+        out[0] = pixel >> 4;
+        out[1] = pixel << 4;
+        out += 2;
+    }
+
+    return out - (uint8_t *) buf;
+}
+
+static void swap_rgb565_lvgl(uint16_t *pixels, size_t count)
+{
+    lv_draw_sw_rgb565_swap(pixels, count);
+}
+
+typedef struct
+{
+    qstr name;
+    void (*swap)(uint16_t *pixels, size_t count);
+} swap_variant_t;
+
+static const swap_variant_t swap_variants[] = {
+    { MP_QSTR_lvgl, swap_rgb565_lvgl },
+    { MP_QSTR_scalar, swap_rgb565_scalar },
+    { MP_QSTR_word, swap_rgb565_word },
+#if CONFIG_IDF_TARGET_ESP32S3
+    { MP_QSTR_pie, swap_rgb565_pie },
+#endif
+};
+
+// Measures every swap implementation on the same buffer and returns a dict of variant name to cycles per pixel. The
+// result of each variant is checked against the scalar one, so this doubles as a self-test of the vector code.
+static mp_obj_t lvgl_esp32_benchmark_swap(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum
+    {
+        ARG_pixels,         // number of pixels to swap per iteration
+        ARG_iterations,     // number of iterations to average over
+        ARG_offset,         // offset in pixels from an aligned address
+    };
+
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_pixels, MP_ARG_INT, { .u_int = 320 * 20 }},
+        { MP_QSTR_iterations, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 100 }},
+        { MP_QSTR_offset, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 0 }},
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_int_t pixels = args[ARG_pixels].u_int;
+    mp_int_t iterations = args[ARG_iterations].u_int;
+    mp_int_t offset = args[ARG_offset].u_int;
+
+    if (pixels <= 0 || iterations <= 0 || offset < 0 || offset > 7)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid benchmark parameters"));
+    }
+
+    size_t size = (pixels + offset) * sizeof(uint16_t);
+    uint16_t *buf = heap_caps_aligned_alloc(16, size, MALLOC_CAP_DMA);
+    uint16_t *expected = heap_caps_malloc(pixels * sizeof(uint16_t), MALLOC_CAP_DEFAULT);
+
+    if (buf == NULL || expected == NULL)
+    {
+        heap_caps_free(buf);
+        heap_caps_free(expected);
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Could not allocate benchmark buffers"));
+    }
+
+    uint16_t *data = buf + offset;
+    for (mp_int_t i = 0; i < pixels; i++)
+    {
+        data[i] = (uint16_t) (i * 0x9E37);
+    }
+
+    memcpy(expected, data, pixels * sizeof(uint16_t));
+    swap_rgb565_scalar(expected, pixels);
+
+    mp_obj_t result = mp_obj_new_dict(MP_ARRAY_SIZE(swap_variants));
+    bool valid = true;
+
+    for (size_t v = 0; v < MP_ARRAY_SIZE(swap_variants); v++)
+    {
+        const swap_variant_t *variant = &swap_variants[v];
+
+        // An odd number of passes leaves the buffer swapped, which is compared against the reference
+        variant->swap(data, pixels);
+        valid &= memcmp(data, expected, pixels * sizeof(uint16_t)) == 0;
+        variant->swap(data, pixels);
+
+        esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+        for (mp_int_t i = 0; i < iterations; i++)
+        {
+            variant->swap(data, pixels);
+        }
+        esp_cpu_cycle_count_t cycles = esp_cpu_get_cycle_count() - start;
+
+        // Keep the buffer unswapped for the next variant
+        if (iterations & 1)
+        {
+            variant->swap(data, pixels);
+        }
+
+        mp_obj_dict_store(
+            result,
+            MP_OBJ_NEW_QSTR(variant->name),
+            mp_obj_new_float((mp_float_t) cycles / ((mp_float_t) iterations * pixels))
+        );
+    }
+
+    heap_caps_free(buf);
+    heap_caps_free(expected);
+
+    if (!valid)
+    {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Swap implementations disagree"));
+    }
+
+    return result;
+}
+MP_DEFINE_CONST_FUN_OBJ_KW(lvgl_esp32_benchmark_swap_obj, 0, lvgl_esp32_benchmark_swap);
@@ -0,0 +1,17 @@
+#ifndef __LVGL_ESP32_SWAP_H__
+#define __LVGL_ESP32_SWAP_H__
+
+#include "py/obj.h"
+
+#include <stddef.h>
+
+// Swaps the two bytes of every RGB565 pixel in place, using the fastest kernel available on the target
+void lvgl_esp32_swap_rgb565(void *buf, size_t pixel_count);
+
+// Packs native RGB565 pixels in place to RGB444 as the panel takes it, two pixels in three bytes, and returns the number
+// of bytes. An odd count ends with half a byte of padding.
+size_t lvgl_esp32_pack_rgb444(void *buf, size_t pixel_count);
+
+MP_DECLARE_CONST_FUN_OBJ_KW(lvgl_esp32_benchmark_swap_obj);
+
+#endif /* __LVGL_ESP32_SWAP_H__ */
@@ -0,0 +1,175 @@
+#include "trace.h"
+
+#include "py/runtime.h"
+
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <stdint.h>
+
+// Text is handed to the stream in pieces of about this size
+#define DUMP_CHUNK_SIZE 512
+
+typedef struct
+{
+    const char *name;
+    int64_t timestamp;
+    uint32_t tid;
+    char phase;
+    uint8_t core;
+} trace_event_t;
+
+volatile bool lvgl_esp32_trace_enabled = false;
+
+static trace_event_t *ring = NULL;
+static uint32_t ring_mask = 0;
+static uint32_t ring_head = 0;
+
+// Writers between testing the flag and finishing their event, the ring is only replaced or read once they are done
+static uint32_t ring_writers = 0;
+
+// Runs in interrupts and on both cores, claiming a slot is the only shared write
+void IRAM_ATTR lvgl_esp32_trace_event(const char *name, char phase)
+{
+    // Recording may have stopped since the caller tested the flag, so it is tested again once counted
+    __atomic_fetch_add(&ring_writers, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&lvgl_esp32_trace_enabled, __ATOMIC_SEQ_CST))
+    {
+        uint32_t index = __atomic_fetch_add(&ring_head, 1, __ATOMIC_RELAXED) & ring_mask;
+        trace_event_t *event = &ring[index];
+
+        event->name = name;
+        event->timestamp = esp_timer_get_time();
+        event->phase = phase;
+        event->core = esp_cpu_get_core_id();
+
+        // Every task gets a track of its own, interrupts get one per core. Handles never collide with core numbers.
+        event->tid = xPortInIsrContext() ? event->core : (uint32_t) (uintptr_t) xTaskGetCurrentTaskHandle();
+    }
+    __atomic_fetch_sub(&ring_writers, 1, __ATOMIC_RELEASE);
+}
+
+// Stops recording and waits for the writers still busy with an event. They may be preempted tasks, so this sleeps.
+static void quiesce(void)
+{
+    __atomic_store_n(&lvgl_esp32_trace_enabled, false, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&ring_writers, __ATOMIC_ACQUIRE) > 0)
+    {
+        vTaskDelay(1);
+    }
+}
+
+void lvgl_esp32_trace_start(size_t events)
+{
+    if (events < 2 || events > (1 << 20))
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("events must be between 2 and 1048576"));
+    }
+
+    // A power of two lets the head simply wrap around
+    uint32_t size = 1;
+    while (size < events)
+    {
+        size <<= 1;
+    }
+
+    quiesce();
+
+    if (ring == NULL || ring_mask + 1 != size)
+    {
+        heap_caps_free(ring);
+        ring_mask = 0;
+
+        // Events are recorded from interrupts too, which can not touch SPIRAM while the flash cache is disabled
+        ring = heap_caps_malloc(size * sizeof(trace_event_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (ring == NULL)
+        {
+            mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Not enough internal memory for the trace"));
+        }
+        ring_mask = size - 1;
+    }
+
+    ring_head = 0;
+    lvgl_esp32_trace_enabled = true;
+}
+
+void lvgl_esp32_trace_stop(void)
+{
+    lvgl_esp32_trace_enabled = false;
+}
+
+static void dump_write(mp_obj_t stream, vstr_t *vstr)
+{
+    mp_obj_t dest[3];
+    mp_load_method(stream, MP_QSTR_write, dest);
+    dest[2] = mp_obj_new_str(vstr_str(vstr), vstr_len(vstr));
+    mp_call_method_n_kw(1, 0, dest);
+    vstr_reset(vstr);
+}
+
+mp_obj_t lvgl_esp32_trace_dump(mp_obj_t stream)
+{
+    // Writers would overwrite the events while they are read
+    bool enabled = lvgl_esp32_trace_enabled;
+    quiesce();
+
+    uint32_t head = ring_head;
+    uint32_t size = ring == NULL ? 0 : ring_mask + 1;
+    uint32_t first = head > size ? head - size : 0;
+
+    // Times are relative to the oldest event, events of other cores may be a bit older
+    int64_t base = head > first ? ring[first & ring_mask].timestamp : 0;
+
+    vstr_t vstr;
+    vstr_init(&vstr, DUMP_CHUNK_SIZE + 128);
+    vstr_add_str(&vstr, "{\"traceEvents\":[");
+
+    for (uint32_t i = first; i < head; i++)
+    {
+        const trace_event_t *event = &ring[i & ring_mask];
+
+        vstr_printf(&vstr, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":", i == first ? "" : ",\n", event->name, event->phase);
+
+        // mp_printf has no 64-bit integers, long captures are printed as seconds and microseconds
+        int64_t ts = event->timestamp - base;
+        if (ts < 0)
+        {
+            vstr_add_str(&vstr, "-");
+            ts = -ts;
+        }
+        if (ts >= 1000000)
+        {
+            vstr_printf(&vstr, "%u%06u", (unsigned int) (ts / 1000000), (unsigned int) (ts % 1000000));
+        }
+        else
+        {
+            vstr_printf(&vstr, "%u", (unsigned int) ts);
+        }
+
+        vstr_printf(&vstr, ",\"pid\":1,\"tid\":%u,\"args\":{\"core\":%u}%s}",
+            (unsigned int) event->tid, event->core, event->phase == 'i' ? ",\"s\":\"t\"" : "");
+
+        if (stream != mp_const_none && vstr_len(&vstr) >= DUMP_CHUNK_SIZE)
+        {
+            dump_write(stream, &vstr);
+        }
+    }
+
+    vstr_add_str(&vstr, "],\"displayTimeUnit\":\"ms\"}\n");
+    lvgl_esp32_trace_enabled = enabled;
+
+    if (stream == mp_const_none)
+    {
+        return mp_obj_new_str_from_vstr(&vstr);
+    }
+
+    dump_write(stream, &vstr);
+    vstr_clear(&vstr);
+
+    return mp_const_none;
+}
@@ -0,0 +1,19 @@
+#ifndef __LVGL_ESP32_TRACE_H__
+#define __LVGL_ESP32_TRACE_H__
+
+#include "py/obj.h"
+
+#include "include/lv_mp_profiler_include.h"
+
+#include <stddef.h>
+
+// Starts recording into a ring of the given number of events, the oldest events are overwritten once it is full
+void lvgl_esp32_trace_start(size_t events);
+
+// Stops recording, the events stay available for lvgl_esp32_trace_dump()
+void lvgl_esp32_trace_stop(void);
+
+// Writes the recorded events as Chrome trace event JSON to stream, or returns them as a str if stream is None
+mp_obj_t lvgl_esp32_trace_dump(mp_obj_t stream);
+
+#endif /* __LVGL_ESP32_TRACE_H__ */
@@ -1,26 +1,1017 @@
 #include "wrapper.h"
 
+#include "swap.h"
+#include "trace.h"
+
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "py/runtime.h"
 
+#include "core/lv_global.h"
+#include "display/lv_display_private.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include <string.h>
+
 static const char *TAG = "lvgl_esp32_wrapper";
 
+// Height of each of the bounce buffers used to send SPIRAM draw buffers
+#define BOUNCE_BUFFER_LINES 10
+
+// Smallest area checked for being a single color, below that a fill saves too little to be worth it
+#define SOLID_FILL_MIN_PIXELS 1024
+
+// Longest wait for a TE pulse before a frame is sent regardless, the panel refreshes at 40 Hz or more
+#define TE_TIMEOUT_MS 50
+
+// Edge of the square tiles whose hashes tell whether a flush changes anything, 16x16 is 512 bytes of RGB565
+#define TILE_SIZE 16
+
+// Longest a wait for a buffer blocks before it checks again, transfers normally finish well within a frame
+#define FLUSH_WAIT_TIMEOUT_MS 20
+
+// Render task configuration, Python callbacks also run on its stack
+#define RENDER_TASK_STACK_SIZE      (16 * 1024)
+#define RENDER_TASK_PRIORITY        (tskIDLE_PRIORITY + 1)
+#define RENDER_TASK_MAX_DELAY_MS    50
+
+#if LVGL_ESP32_USE_OS && !(MICROPY_PY_THREAD && MICROPY_PY_THREAD_GIL)
+#error "LVGL_ESP32_USE_OS requires a MicroPython build with threads and a GIL"
+#endif
+
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
+// The pools of LVGL's builtin allocator, outside of the MicroPython heap. The GC does not scan them, the Python objects
+// only LVGL refers to are kept reachable by the binding instead.
+static void *mem_pool = NULL;
+static void *mem_pool_extra = NULL;
+
+// Called by lv_init() for the pool of LVGL's builtin allocator, which setup() allocated before
+void *lvgl_esp32_mem_pool_alloc(size_t size)
+{
+    return mem_pool;
+}
+
+static uint32_t mem_region_caps(lvgl_esp32_mem_region_t region)
+{
+    return (region == LVGL_ESP32_MEM_SPIRAM ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL) | MALLOC_CAP_8BIT;
+}
+#endif
+
+#if LVGL_ESP32_USE_OS
+// The wrapper of the running render task. Being reachable, it is never finalised by a GC while the task runs.
+MP_REGISTER_ROOT_POINTER(mp_obj_t lvgl_esp32_render_wrapper);
+
+// The task currently running LVGL, if any, and how deep it is in Python callbacks
+static TaskHandle_t render_task_handle = NULL;
+static int render_task_callback_depth = 0;
+
+void lvgl_esp32_callback_enter(void)
+{
+    LVGL_ESP32_TRACE_BEGIN("python_callback");
+
+    if (render_task_handle == NULL || xTaskGetCurrentTaskHandle() != render_task_handle)
+    {
+        return;
+    }
+
+    if (render_task_callback_depth++ == 0)
+    {
+        MP_THREAD_GIL_ENTER();
+
+        // The VM only hands the GIL to other threads while the scheduler is unlocked. Keeping it for the whole callback
+        // makes sure no other thread runs a GC while objects only referenced from the render task's stack are in use.
+        mp_sched_lock();
+    }
+}
+
+void lvgl_esp32_callback_exit(void)
+{
+    LVGL_ESP32_TRACE_END("python_callback");
+
+    if (render_task_handle == NULL || xTaskGetCurrentTaskHandle() != render_task_handle)
+    {
+        return;
+    }
+
+    if (--render_task_callback_depth == 0)
+    {
+        mp_sched_unlock();
+        MP_THREAD_GIL_EXIT();
+    }
+}
+
+// On the render task an exception leaving the outermost callback can only end up in render_task_exception(), which
+// needs the GIL again. That callback keeps it, so no other thread can run a GC while the exception is in flight.
+void lvgl_esp32_callback_raise(void)
+{
+    LVGL_ESP32_TRACE_END("python_callback");
+
+    if (render_task_handle == NULL || xTaskGetCurrentTaskHandle() != render_task_handle)
+    {
+        return;
+    }
+
+    if (render_task_callback_depth > 1)
+    {
+        render_task_callback_depth--;
+    }
+}
+
+static void render_task_exception(mp_obj_t exception)
+{
+    // The outermost callback the exception went through kept the GIL, otherwise it did not come from a callback
+    if (render_task_callback_depth > 0)
+    {
+        render_task_callback_depth = 0;
+    }
+    else
+    {
+        MP_THREAD_GIL_ENTER();
+        mp_sched_lock();
+    }
+
+    mp_printf(&mp_plat_print, "Uncaught exception in LVGL render task\n");
+    mp_obj_print_exception(&mp_plat_print, exception);
+
+    mp_sched_unlock();
+    MP_THREAD_GIL_EXIT();
+
+    // lv_timer_handler() was left halfway, allow it to run again
+    LV_GLOBAL_DEFAULT()->timer_state.already_running = false;
+}
+
+static void render_task(void *arg)
+{
+    lvgl_esp32_Wrapper_obj_t *self = (lvgl_esp32_Wrapper_obj_t *) arg;
+
+    // Python callbacks run on this task, so it needs a MicroPython thread state of its own
+    mp_state_thread_t ts;
+    mp_thread_init_state(&ts, RENDER_TASK_STACK_SIZE - 1024, NULL, NULL);
+
+    render_task_handle = xTaskGetCurrentTaskHandle();
+    ESP_LOGI(TAG, "Render task started");
+
+    while (!self->render_task_stop)
+    {
+        uint32_t delay = RENDER_TASK_MAX_DELAY_MS;
+        nlr_buf_t nlr;
+
+        lv_mutex_lock(&self->render_lock);
+        if (nlr_push(&nlr) == 0)
+        {
+            delay = lv_timer_handler();
+            nlr_pop();
+        }
+        else
+        {
+            render_task_exception(MP_OBJ_FROM_PTR(nlr.ret_val));
+        }
+        lv_mutex_unlock(&self->render_lock);
+
+        vTaskDelay(LV_MAX(1, pdMS_TO_TICKS(LV_MIN(delay, RENDER_TASK_MAX_DELAY_MS))));
+    }
+
+    ESP_LOGI(TAG, "Render task stopped");
+    render_task_handle = NULL;
+    self->render_task_running = false;
+    vTaskDelete(NULL);
+}
+
+static void render_task_start(lvgl_esp32_Wrapper_obj_t *self)
+{
+    int core = self->render_core;
+    if (core < 0)
+    {
+#if CONFIG_FREERTOS_UNICORE
+        core = 0;
+#else
+        // Use the core MicroPython is not running on
+        core = !xPortGetCoreID();
+#endif
+    }
+
+    ESP_LOGI(TAG, "Starting render task on core %d", core);
+    lv_mutex_init(&self->render_lock);
+    self->render_lock_depth = 0;
+    self->render_task_stop = false;
+    self->render_task_running = true;
+    MP_STATE_VM(lvgl_esp32_render_wrapper) = MP_OBJ_FROM_PTR(self);
+
+    if (xTaskCreatePinnedToCore(
+        render_task,
+        "lvgl_render",
+        RENDER_TASK_STACK_SIZE,
+        self,
+        RENDER_TASK_PRIORITY,
+        NULL,
+        core
+    ) != pdPASS)
+    {
+        self->render_task_running = false;
+        MP_STATE_VM(lvgl_esp32_render_wrapper) = MP_OBJ_NULL;
+        lv_mutex_delete(&self->render_lock);
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Could not start render task"));
+    }
+}
+
+static void render_task_stop(lvgl_esp32_Wrapper_obj_t *self)
+{
+    if (!self->render_task_running)
+    {
+        return;
+    }
+
+    ESP_LOGI(TAG, "Stopping render task");
+    self->render_task_stop = true;
+
+    // The render task may need the GIL to finish its current cycle
+    MP_THREAD_GIL_EXIT();
+    while (self->render_task_running)
+    {
+        vTaskDelay(1);
+    }
+    MP_THREAD_GIL_ENTER();
+
+    lv_mutex_delete(&self->render_lock);
+    self->render_lock_depth = 0;
+    MP_STATE_VM(lvgl_esp32_render_wrapper) = MP_OBJ_NULL;
+}
+#endif
+
+// Takes the lock guarding LVGL against the render task. Without a render task this does nothing.
+static void render_lock_take(lvgl_esp32_Wrapper_obj_t *self)
+{
+#if LVGL_ESP32_USE_OS
+    if (!self->render_task_running)
+    {
+        return;
+    }
+
+    if (xTaskGetCurrentTaskHandle() == render_task_handle)
+    {
+        // Called from a callback in the render task, which already holds the lock
+        lv_mutex_lock(&self->render_lock);
+    }
+    else
+    {
+        // The render task may need the GIL to finish its current cycle
+        MP_THREAD_GIL_EXIT();
+        lv_mutex_lock(&self->render_lock);
+        MP_THREAD_GIL_ENTER();
+    }
+    self->render_lock_depth++;
+#endif
+}
+
+// Gives back the lock if it was taken, the render task may have started or stopped since
+static void render_lock_give(lvgl_esp32_Wrapper_obj_t *self)
+{
+#if LVGL_ESP32_USE_OS
+    if (self->render_lock_depth > 0)
+    {
+        self->render_lock_depth--;
+        lv_mutex_unlock(&self->render_lock);
+    }
+#endif
+}
+
+static void histogram_add(lvgl_esp32_histogram_t *histogram, int64_t value)
+{
+    uint32_t clamped = value < 0 ? 0 : (value > UINT32_MAX ? UINT32_MAX : (uint32_t) value);
+    int bucket = clamped == 0 ? 0 : 32 - __builtin_clz(clamped);
+
+    histogram->count++;
+    histogram->total += clamped;
+    histogram->max = clamped > histogram->max ? clamped : histogram->max;
+    histogram->buckets[bucket < LVGL_ESP32_HISTOGRAM_BUCKETS ? bucket : LVGL_ESP32_HISTOGRAM_BUCKETS - 1]++;
+}
+
+static void swap_pixels(lvgl_esp32_Wrapper_obj_t *self, void *buf, size_t pixel_count)
+{
+    int64_t start = esp_timer_get_time();
+    LVGL_ESP32_TRACE_BEGIN("swap");
+
+    lvgl_esp32_swap_rgb565(buf, pixel_count);
+
+    LVGL_ESP32_TRACE_END("swap");
+    histogram_add(&self->swap_us, esp_timer_get_time() - start);
+}
+
+// Sends an area from a SPIRAM draw buffer in chunks that are copied to the internal bounce buffers first, the transfer
+// done callback signals LVGL once the last chunk is out
+static void flush_bounce(lvgl_esp32_Wrapper_obj_t *self, const lv_area_t *area, const uint8_t *data)
+{
+    int32_t width = lv_area_get_width(area);
+    int32_t chunk_lines = LV_MAX(1, self->bounce_size / (width * sizeof(uint16_t)));
+
+    for (int32_t y = area->y1; y <= area->y2; y += chunk_lines)
+    {
+        int32_t lines = LV_MIN(chunk_lines, area->y2 - y + 1);
+        size_t pixels = width * lines;
+        uint8_t slot = self->bounce_next;
+        self->bounce_next ^= 1;
+
+        // Wait until the previous transfer from this bounce buffer is done
+        while (self->bounce_busy[slot])
+        {
+            xSemaphoreTake(self->flush_semaphore, pdMS_TO_TICKS(FLUSH_WAIT_TIMEOUT_MS));
+        }
+
+        memcpy(self->bounce_buf[slot], data, pixels * sizeof(uint16_t));
+        data += pixels * sizeof(uint16_t);
+
+        if (self->display->swap_bytes)
+        {
+            swap_pixels(self, self->bounce_buf[slot], pixels);
+        }
+
+        self->bounce_busy[slot] = true;
+        if (y + lines > area->y2)
+        {
+            self->bounce_last = true;
+        }
+
+        lvgl_esp32_Display_draw_bitmap(
+            self->display,
+            area->x1,
+            y,
+            area->x2 + 1,
+            y + lines,
+            self->bounce_buf[slot],
+            true
+        );
+    }
+}
+
+static int64_t area_bytes(const lv_area_t *area)
+{
+    return (int64_t) lv_area_get_size(area) * sizeof(uint16_t);
+}
+
+// Grows an area being invalidated to the bounding box of it and the areas invalidated before in this refresh whenever
+// sending that box is cheaper than sending them separately, counting every transaction as the configured overhead in
+// bytes. LVGL then folds the areas inside the box into it when it joins its invalidated areas.
+static void coalesce_area(lvgl_esp32_Wrapper_obj_t *self, lv_area_t *area)
+{
+    self->coalesce_areas++;
+
+    bool merged;
+    do
+    {
+        merged = false;
+
+        for (uint32_t i = 0; i < self->coalesce_count; i++)
+        {
+            lv_area_t *box = &self->coalesce_boxes[i];
+            lv_area_t joined;
+            lv_area_join(&joined, box, area);
+
+            if (area_bytes(&joined) >= area_bytes(box) + area_bytes(area) + self->coalesce_overhead)
+            {
+                continue;
+            }
+
+            // Pixels of both areas now sent together, and pixels of the box that neither of them had
+            lv_area_t common;
+            uint32_t overlap = lv_area_intersect(&common, box, area) ? lv_area_get_size(&common) : 0;
+            uint32_t covered = lv_area_get_size(box) + lv_area_get_size(area) - overlap;
+
+            self->coalesce_merges++;
+            self->coalesce_merged_pixels += covered;
+            self->coalesce_extra_pixels += lv_area_get_size(&joined) - covered;
+
+            *area = joined;
+            self->coalesce_boxes[i] = self->coalesce_boxes[--self->coalesce_count];
+            merged = true;
+            break;
+        }
+    }
+    while (merged);
+
+    if (self->coalesce_count < LV_INV_BUF_SIZE)
+    {
+        self->coalesce_boxes[self->coalesce_count++] = *area;
+    }
+}
+
+static void coalesce_refr_ready_cb(lv_event_t *event)
+{
+    lvgl_esp32_Wrapper_obj_t *self = (lvgl_esp32_Wrapper_obj_t *) lv_event_get_user_data(event);
+
+    self->coalesce_count = 0;
+}
+
+// LVGL objects hand out the pointer to their native object through the buffer protocol
+static lv_obj_t *get_lv_obj(mp_obj_t obj)
+{
+    mp_buffer_info_t bufinfo;
+
+    if (!mp_get_buffer(obj, &bufinfo, MP_BUFFER_READ)
+        || bufinfo.len != sizeof(lv_obj_t *)
+        || !lv_obj_is_valid(*(lv_obj_t **) bufinfo.buf))
+    {
+        mp_raise_TypeError(MP_ERROR_TEXT("Expected an LVGL object"));
+    }
+
+    return *(lv_obj_t **) bufinfo.buf;
+}
+
+static void scroll_invalidate_area(lvgl_esp32_Wrapper_obj_t *self)
+{
+    lv_area_t area = {
+        .x1 = 0,
+        .y1 = self->display->scroll_top,
+        .x2 = self->display->width - 1,
+        .y2 = self->display->scroll_top + self->display->scroll_height - 1,
+    };
+
+    lv_inv_area(self->lv_display, &area);
+}
+
+static void scroll_cb(lv_event_t *event)
+{
+    lvgl_esp32_Wrapper_obj_t *self = (lvgl_esp32_Wrapper_obj_t *) lv_event_get_user_data(event);
+    lvgl_esp32_Display_obj_t *display = self->display;
+
+    int32_t scroll_y = lv_obj_get_scroll_y(self->scroll_obj);
+    int32_t dy = scroll_y - self->scroll_y;
+    self->scroll_y = scroll_y;
+
+    lv_area_t coords;
+    lv_obj_get_coords(self->scroll_obj, &coords);
+    int32_t top = LV_MAX(coords.y1, 0);
+    int32_t bottom = LV_MIN(coords.y2 + 1, display->height);
+
+    // Only objects spanning the width of the screen can be scrolled by the panel, and only when rows remain visible
+    if (display->swap_xy || display->mirror_y || dy == 0 || coords.x1 > 0 || coords.x2 < display->width - 1 || LV_ABS(dy) >= bottom - top)
+    {
+        return;
+    }
+
+    if (display->scroll_top != top || display->scroll_height != bottom - top)
+    {
+        // The object moved or scrolls for the first time. Rows of an earlier scroll area have to be drawn again, the
+        // invalidation of the object that follows draws the new one.
+        if (display->scroll_height > 0)
+        {
+            scroll_invalidate_area(self);
+        }
+        lvgl_esp32_Display_set_scroll_area(display, top, bottom - top);
+        return;
+    }
+
+    // Areas waiting to be drawn still show old pixels, which move along. Where they end up has to be drawn too.
+    lv_display_t *lv_display = self->lv_display;
+    lv_area_t scroll_area = { .x1 = 0, .y1 = top, .x2 = display->width - 1, .y2 = bottom - 1 };
+    lv_area_t moved[LV_INV_BUF_SIZE];
+    uint32_t moved_count = 0;
+
+    for (uint32_t i = 0; i < lv_display->inv_p; i++)
+    {
+        lv_area_t area;
+        if (!lv_display->inv_area_joined[i] && lv_area_intersect(&area, &lv_display->inv_areas[i], &scroll_area))
+        {
+            lv_area_move(&area, 0, -dy);
+            if (lv_area_intersect(&area, &area, &scroll_area))
+            {
+                moved[moved_count++] = area;
+            }
+        }
+    }
+
+    lvgl_esp32_Display_scroll(display, dy);
+    self->hw_scrolls++;
+
+    for (uint32_t i = 0; i < moved_count; i++)
+    {
+        lv_inv_area(lv_display, &moved[i]);
+    }
+
+    // So does the scrollbar
+    lv_area_t hor;
+    lv_area_t ver;
+    lv_obj_get_scrollbar_area(self->scroll_obj, &hor, &ver);
+    if (lv_area_get_size(&ver) > 0)
+    {
+        ver.y1 = top;
+        ver.y2 = bottom - 1;
+        lv_inv_area(lv_display, &ver);
+    }
+
+    // The object invalidates all of itself right after this event, while only the rows that came in are needed
+    self->scroll_exposed = scroll_area;
+    if (dy > 0)
+    {
+        self->scroll_exposed.y1 = bottom - dy;
+    }
+    else
+    {
+        self->scroll_exposed.y2 = top - dy - 1;
+    }
+    self->scroll_pending = true;
+}
+
+static void invalidate_area_cb(lv_event_t *event)
+{
+    lvgl_esp32_Wrapper_obj_t *self = (lvgl_esp32_Wrapper_obj_t *) lv_event_get_user_data(event);
+    lv_area_t *area = (lv_area_t *) lv_event_get_param(event);
+
+    if (self->scroll_pending)
+    {
+        self->scroll_pending = false;
+
+        if (area->y1 <= self->display->scroll_top
+            && area->y2 >= self->display->scroll_top + self->display->scroll_height - 1)
+        {
+            *area = self->scroll_exposed;
+        }
+    }
+
+    if (self->coalesce)
+    {
+        coalesce_area(self, area);
+    }
+}
+
+// Stops hardware scrolling, drawing the rotated rows of the scroll area again in place
+static void scroll_release(lvgl_esp32_Wrapper_obj_t *self)
+{
+    self->scroll_obj = NULL;
+    self->scroll_pending = false;
+
+    if (self->display->io_handle != NULL && self->display->scroll_height > 0)
+    {
+        scroll_invalidate_area(self);
+        lvgl_esp32_Display_set_scroll_area(self->display, 0, 0);
+    }
+}
+
+static void scroll_delete_cb(lv_event_t *event)
+{
+    scroll_release((lvgl_esp32_Wrapper_obj_t *) lv_event_get_user_data(event));
+}
+
+// Holds back the first flush of every frame until the panel starts a refresh, so the transfer runs behind the scan
+static void frame_sync_te(lvgl_esp32_Wrapper_obj_t *self, lv_display_t *display)
+{
+    if (self->frame_start)
+    {
+        int64_t start = esp_timer_get_time();
+
+        if (lvgl_esp32_Display_wait_te(self->display, TE_TIMEOUT_MS))
+        {
+            self->frame_te_us = self->display->te_last_us;
+        }
+        else
+        {
+            self->frame_te_us = 0;
+            self->te_timeouts++;
+        }
+
+        self->te_wait_us += esp_timer_get_time() - start;
+        self->frame_start = false;
+    }
+
+    if (lv_display_flush_is_last(display))
+    {
+        self->frame_last_flush = true;
+        self->frame_start = true;
+    }
+}
+
+// Called when the last transfer of a frame is done
+static void frame_done(lvgl_esp32_Wrapper_obj_t *self)
+{
+    self->frame_last_flush = false;
+    self->frames++;
+
+    if (self->frame_te_us == 0)
+    {
+        return;
+    }
+
+    self->frame_us = esp_timer_get_time() - self->frame_te_us;
+    if (self->display->te_period_us > 0 && self->frame_us > self->display->te_period_us)
+    {
+        self->frames_late++;
+    }
+}
+
+// Gives up at the first pixel that differs, which is early for nearly everything that is not solid
+static bool is_solid(const uint16_t *pixels, size_t count)
+{
+    uint16_t first = pixels[0];
+
+    for (size_t i = 1; i < count; i++)
+    {
+        if (pixels[i] != first)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool transfer_done_cb(void *user_data);
+
+static size_t tile_count(lvgl_esp32_Wrapper_obj_t *self)
+{
+    // The same in every rotation
+    return (size_t) ((self->display->width + TILE_SIZE - 1) / TILE_SIZE)
+        * ((self->display->height + TILE_SIZE - 1) / TILE_SIZE);
+}
+
+// Forgets the hashes of all tiles touching the area, which was sent some other way
+static void tiles_forget(lvgl_esp32_Wrapper_obj_t *self, const lv_area_t *area)
+{
+    int32_t tiles_x = (self->display->width + TILE_SIZE - 1) / TILE_SIZE;
+
+    for (int32_t ty = area->y1 / TILE_SIZE; ty <= area->y2 / TILE_SIZE; ty++)
+    {
+        for (int32_t tx = area->x1 / TILE_SIZE; tx <= area->x2 / TILE_SIZE; tx++)
+        {
+            self->tile_hashes[ty * tiles_x + tx] = 0;
+        }
+    }
+}
+
+// FNV-1a over the rows of a tile, taking two pixels at a time where it can
+static uint32_t tile_hash(const uint16_t *pixels, int32_t stride, int32_t width, int32_t height)
+{
+    uint32_t hash = 2166136261u;
+
+    for (int32_t y = 0; y < height; y++)
+    {
+        const uint16_t *row = pixels + y * stride;
+        int32_t x = 0;
+
+        for (; x + 2 <= width; x += 2)
+        {
+            hash = (hash ^ (row[x] | (uint32_t) row[x + 1] << 16)) * 16777619u;
+        }
+        if (x < width)
+        {
+            hash = (hash ^ row[x]) * 16777619u;
+        }
+    }
+
+    return hash != 0 ? hash : 1;
+}
+
+// Sends the rows of a flush that start at data, narrowed down to the columns from x1 to x2. Those are moved together
+// in place first, the draw buffer is not read again before LVGL gets it back.
+static void send_band(
+    lvgl_esp32_Wrapper_obj_t *self,
+    const lv_area_t *area,
+    uint16_t *data,
+    int32_t y,
+    int32_t rows,
+    int32_t x1,
+    int32_t x2,
+    bool notify
+)
+{
+    int32_t width = lv_area_get_width(area);
+    int32_t band_width = x2 - x1 + 1;
+
+    if (band_width < width)
+    {
+        for (int32_t row = 0; row < rows; row++)
+        {
+            memmove(data + row * band_width, data + row * width + (x1 - area->x1), band_width * sizeof(uint16_t));
+        }
+    }
+
+    if (self->display->swap_bytes)
+    {
+        swap_pixels(self, data, band_width * rows);
+    }
+
+    lvgl_esp32_Display_draw_bitmap(self->display, x1, y, x2 + 1, y + rows, data, notify);
+}
+
+// Goes through a flush in bands of tile rows and sends, for every band, the columns from the first to the last tile
+// whose hash changed. Tiles the flush only partly covers can not be compared and are always sent.
+static void flush_tiles(lvgl_esp32_Wrapper_obj_t *self, const lv_area_t *area, uint16_t *data)
+{
+    lvgl_esp32_Display_obj_t *display = self->display;
+    int32_t width = lv_area_get_width(area);
+    int32_t tiles_x = (display->width + TILE_SIZE - 1) / TILE_SIZE;
+
+    // Bands waiting to be sent, the last one is held back so it can be the one that notifies
+    bool pending = false;
+    uint16_t *pending_data = NULL;
+    int32_t pending_y = 0;
+    int32_t pending_rows = 0;
+    int32_t pending_x1 = 0;
+    int32_t pending_x2 = 0;
+
+    for (int32_t y = area->y1; y <= area->y2;)
+    {
+        int32_t ty = y / TILE_SIZE;
+        int32_t tile_y2 = LV_MIN(ty * TILE_SIZE + TILE_SIZE, display->height) - 1;
+        int32_t band_y2 = LV_MIN(tile_y2, area->y2);
+        int32_t rows = band_y2 - y + 1;
+        bool whole_rows = y == ty * TILE_SIZE && band_y2 == tile_y2;
+        uint16_t *band = data + (y - area->y1) * width;
+
+        int32_t changed_x1 = -1;
+        int32_t changed_x2 = -1;
+
+        for (int32_t tx = area->x1 / TILE_SIZE; tx <= area->x2 / TILE_SIZE; tx++)
+        {
+            int32_t tile_x1 = tx * TILE_SIZE;
+            int32_t tile_x2 = LV_MIN(tile_x1 + TILE_SIZE, display->width) - 1;
+            int32_t x1 = LV_MAX(tile_x1, area->x1);
+            int32_t x2 = LV_MIN(tile_x2, area->x2);
+            uint32_t *entry = &self->tile_hashes[ty * tiles_x + tx];
+            bool changed = true;
+
+            if (whole_rows && x1 == tile_x1 && x2 == tile_x2)
+            {
+                uint32_t hash = tile_hash(band + (x1 - area->x1), width, x2 - x1 + 1, rows);
+                changed = hash != *entry;
+                *entry = hash;
+            }
+            else
+            {
+                *entry = 0;
+            }
+
+            if (changed)
+            {
+                changed_x1 = changed_x1 < 0 ? x1 : changed_x1;
+                changed_x2 = x2;
+            }
+        }
+
+        // Everything outside of the changed columns stays as it is on the screen
+        int32_t sent = changed_x1 < 0 ? 0 : changed_x2 - changed_x1 + 1;
+        self->tile_skipped_bytes += (uint64_t) (width - sent) * rows * sizeof(uint16_t);
+
+        if (sent > 0)
+        {
+            if (pending)
+            {
+                send_band(self, area, pending_data, pending_y, pending_rows, pending_x1, pending_x2, false);
+            }
+
+            pending = true;
+            pending_data = band;
+            pending_y = y;
+            pending_rows = rows;
+            pending_x1 = changed_x1;
+            pending_x2 = changed_x2;
+        }
+
+        y = band_y2 + 1;
+    }
+
+    if (pending)
+    {
+        send_band(self, area, pending_data, pending_y, pending_rows, pending_x1, pending_x2, true);
+    }
+    else
+    {
+        // Nothing to send, the flush is done right away
+        transfer_done_cb(self);
+    }
+}
+
+static void flush(lvgl_esp32_Wrapper_obj_t *self, lv_display_t *display, const lv_area_t *area, uint8_t *data)
+{
+    lv_area_t send_area = *area;
+
+    if (self->display->te_semaphore != NULL)
+    {
+        frame_sync_te(self, display);
+    }
+
+    // The screen was changed behind the back of LVGL, nothing that was sent before can be relied on
+    if (self->tile_hashes != NULL && self->tile_foreign_writes != self->display->foreign_writes)
+    {
+        memset(self->tile_hashes, 0, tile_count(self) * sizeof(uint32_t));
+        self->tile_foreign_writes = self->display->foreign_writes;
+    }
+
+    // In DIRECT mode the draw buffer holds the whole frame, send complete lines so the pixels are contiguous
+    if (self->render_mode == LV_DISPLAY_RENDER_MODE_DIRECT)
+    {
+        int32_t width = lv_display_get_horizontal_resolution(display);
+        data += area->y1 * width * sizeof(uint16_t);
+        send_area.x1 = 0;
+        send_area.x2 = width - 1;
+    }
+
+    // Solid areas are sent from the fill pattern of the display, skipping the byte swap and the bounce buffers
+    size_t pixels = lv_area_get_size(&send_area);
+    if (self->solid_fill && pixels >= SOLID_FILL_MIN_PIXELS && is_solid((const uint16_t *) data, pixels))
+    {
+        self->solid_pending = true;
+        lvgl_esp32_Display_fill_rect(
+            self->display,
+            send_area.x1,
+            send_area.y1,
+            lv_area_get_width(&send_area),
+            lv_area_get_height(&send_area),
+            *(const uint16_t *) data,
+            true
+        );
+        self->solid_fills++;
+
+        if (self->tile_hashes != NULL)
+        {
+            tiles_forget(self, &send_area);
+        }
+        return;
+    }
+
+    if (self->tile_hashes != NULL)
+    {
+        flush_tiles(self, &send_area, (uint16_t *) data);
+        return;
+    }
+
+    if (self->memory == LVGL_ESP32_MEMORY_SPIRAM_BOUNCE)
+    {
+        flush_bounce(self, &send_area, data);
+        return;
+    }
+
+    // Correct byte order, only for the pixels that were actually rendered. Panels configured for little-endian data
+    // take LVGL's native RGB565 as is.
+    if (self->display->swap_bytes)
+    {
+        swap_pixels(self, data, pixels);
+    }
+
+    // Blit to the screen
+    lvgl_esp32_Display_draw_bitmap(
+        self->display,
+        send_area.x1,
+        send_area.y1,
+        send_area.x2 + 1,
+        send_area.y2 + 1,
+        data,
+        true
+    );
+}
+
 static void flush_cb(lv_display_t *display, const lv_area_t *area, uint8_t *data)
 {
-    lvgl_esp32_Wrapper_obj_t *self = (lvgl_esp32_Wrapper_obj_t *) lv_display_get_user_data(display);;
+    lvgl_esp32_Wrapper_obj_t *self = (lvgl_esp32_Wrapper_obj_t *) lv_display_get_user_data(display);
+    int64_t start = esp_timer_get_time();
+    LVGL_ESP32_TRACE_BEGIN("flush_cb");
+
+    flush(self, display, area, data);
+
+    LVGL_ESP32_TRACE_END("flush_cb");
+    int64_t elapsed = esp_timer_get_time() - start;
+    histogram_add(&self->flush_us, elapsed);
+    self->refr_other_us += elapsed;
+    self->refr_flushes++;
+}
+
+// LVGL waits here before it renders into a buffer that is still being sent
+static void flush_wait_cb(lv_display_t *display)
+{
+    lvgl_esp32_Wrapper_obj_t *self = (lvgl_esp32_Wrapper_obj_t *) lv_display_get_user_data(display);
+    int64_t start = esp_timer_get_time();
+
+    // A give left over from an earlier transfer only costs another check of the flag
+    while (display->flushing)
+    {
+        xSemaphoreTake(self->flush_semaphore, pdMS_TO_TICKS(FLUSH_WAIT_TIMEOUT_MS));
+    }
+
+    int64_t elapsed = esp_timer_get_time() - start;
+    histogram_add(&self->wait_us, elapsed);
+    self->refr_other_us += elapsed;
+}
+
+static void stats_refr_start_cb(lv_event_t *event)
+{
+    lvgl_esp32_Wrapper_obj_t *self = (lvgl_esp32_Wrapper_obj_t *) lv_event_get_user_data(event);
 
-    // Correct byte order
-    lv_draw_sw_rgb565_swap(data, self->buf_size);
+    self->refr_start_us = esp_timer_get_time();
+    self->refr_other_us = 0;
+    self->refr_flushes = 0;
+}
+
+static void stats_refr_ready_cb(lv_event_t *event)
+{
+    lvgl_esp32_Wrapper_obj_t *self = (lvgl_esp32_Wrapper_obj_t *) lv_event_get_user_data(event);
+
+    self->stats_refreshes++;
+    if (self->refr_flushes == 0)
+    {
+        return;
+    }
+
+    histogram_add(&self->render_us, esp_timer_get_time() - self->refr_start_us - self->refr_other_us);
+    histogram_add(&self->flushes, self->refr_flushes);
+}
+
+static void stats_reset(lvgl_esp32_Wrapper_obj_t *self)
+{
+    self->stats_start_us = esp_timer_get_time();
+    self->stats_refreshes = 0;
+    memset(&self->render_us, 0, sizeof(self->render_us));
+    memset(&self->flush_us, 0, sizeof(self->flush_us));
+    memset(&self->swap_us, 0, sizeof(self->swap_us));
+    memset(&self->wait_us, 0, sizeof(self->wait_us));
+    memset(&self->flushes, 0, sizeof(self->flushes));
+    self->refr_start_us = 0;
+    self->refr_other_us = 0;
+    self->refr_flushes = 0;
+
+    self->display->color_bytes = 0;
+    self->display->color_transactions = 0;
+
+    self->solid_fills = 0;
+    self->display->polled_flushes = 0;
+    self->display->queued_flushes = 0;
+    self->display->continued_writes = 0;
+    self->hw_scrolls = 0;
+    self->tile_skipped_bytes = 0;
+}
+
+// Wakes whoever waits for a buffer, the callback also runs directly from flush_cb for flushes that were polled
+static bool flush_signal(lvgl_esp32_Wrapper_obj_t *self)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (xPortInIsrContext())
+    {
+        xSemaphoreGiveFromISR(self->flush_semaphore, &woken);
+    }
+    else
+    {
+        xSemaphoreGive(self->flush_semaphore);
+    }
+
+    return woken == pdTRUE;
+}
+
+static bool transfer_done_cb(void *user_data)
+{
+    lvgl_esp32_Wrapper_obj_t *self = (lvgl_esp32_Wrapper_obj_t *) user_data;
+    LVGL_ESP32_TRACE_INSTANT("transfer_done");
+
+    if (self->solid_pending)
+    {
+        // A fill took the place of the whole flush, the bounce buffers were not used
+        self->solid_pending = false;
+    }
+    else if (self->memory == LVGL_ESP32_MEMORY_SPIRAM_BOUNCE)
+    {
+        // Transfers complete in the order they were queued and the bounce buffers are used in turns
+        self->bounce_busy[self->bounce_done] = false;
+        self->bounce_done ^= 1;
+
+        if (!self->bounce_last || self->bounce_busy[0] || self->bounce_busy[1])
+        {
+            return flush_signal(self);
+        }
+        self->bounce_last = false;
+    }
+
+    if (self->frame_last_flush)
+    {
+        frame_done(self);
+    }
+
+    lv_disp_flush_ready(self->lv_display);
+
+    return flush_signal(self);
+}
+
+// The display was turned, LVGL renders at its new size into the same buffers and draws everything again
+static void rotation_cb(void *user_data)
+{
+    lvgl_esp32_Wrapper_obj_t *self = (lvgl_esp32_Wrapper_obj_t *) user_data;
+
+    lv_display_set_resolution(self->lv_display, self->display->width, self->display->height);
+    lv_display_set_buffers(self->lv_display, self->buf1, self->buf2, self->buf_size, self->render_mode);
+    self->scroll_pending = false;
+
+    lv_area_t area = { .x1 = 0, .y1 = 0, .x2 = self->display->width - 1, .y2 = self->display->height - 1 };
+    lv_inv_area(self->lv_display, &area);
+}
 
-    // Blit to the screen
-    lvgl_esp32_Display_draw_bitmap(self->display, area->x1, area->y1, area->x2 + 1, area->y2 + 1, data);
+// Display methods called from Python send to the panel like the render task does, so they take its lock
+static void display_lock_cb(void *user_data)
+{
+    render_lock_take((lvgl_esp32_Wrapper_obj_t *) user_data);
 }
 
-static void transfer_done_cb(void *user_data)
+static void display_unlock_cb(void *user_data)
 {
-    lvgl_esp32_Wrapper_obj_t *self = (lvgl_esp32_Wrapper_obj_t *) user_data;
-    lv_disp_flush_ready(self->lv_display);
+    render_lock_give((lvgl_esp32_Wrapper_obj_t *) user_data);
 }
 
 static uint32_t tick_get_cb()
@@ -28,38 +1019,182 @@ static uint32_t tick_get_cb()
     return esp_timer_get_time() / 1000;
 }
 
-static mp_obj_t lvgl_esp32_Wrapper_init(mp_obj_t self_ptr)
+static void setup(lvgl_esp32_Wrapper_obj_t *self)
 {
-    lvgl_esp32_Wrapper_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
-
-    ESP_LOGI(TAG, "Initializing LVGL Wrapper");
-
     if (!lv_is_initialized())
     {
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
+        // lv_init() takes the LV_MEM_SIZE bytes fixed at build time, the rest is a second pool of the same allocator
+        uint32_t caps = mem_region_caps(self->mem_region);
+        size_t extra_size = self->mem_size > LV_MEM_SIZE ? self->mem_size - LV_MEM_SIZE : 0;
+
+        mem_pool = heap_caps_malloc(LV_MEM_SIZE, caps);
+        mem_pool_extra = extra_size > 0 ? heap_caps_malloc(extra_size, caps) : NULL;
+        if (mem_pool == NULL || (extra_size > 0 && mem_pool_extra == NULL))
+        {
+            heap_caps_free(mem_pool);
+            heap_caps_free(mem_pool_extra);
+            mem_pool = NULL;
+            mem_pool_extra = NULL;
+            mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Not enough memory for the LVGL memory pool"));
+        }
+#endif
+
         ESP_LOGI(TAG, "Initializing LVGL library");
         lv_init();
+
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
+        if (mem_pool_extra != NULL)
+        {
+            ESP_LOGI(TAG, "Adding %zu bytes to the LVGL memory pool", extra_size);
+            lv_mem_add_pool(mem_pool_extra, extra_size);
+        }
+#endif
     }
 
     ESP_LOGI(TAG, "Initializing LVGL display with size %dx%d", self->display->width, self->display->height);
     self->lv_display = lv_display_create(self->display->width, self->display->height);
 
-    ESP_LOGI(TAG, "Creating display buffers");
-    self->buf_size = self->display->width * 20;
-    self->buf1 = heap_caps_malloc(self->buf_size * sizeof(lv_color_t), MALLOC_CAP_DMA);
-    assert(self->buf1);
-    self->buf2 = heap_caps_malloc(self->buf_size * sizeof(lv_color_t), MALLOC_CAP_DMA);
-    assert(self->buf2);
+    size_t line_size = self->display->width * sizeof(uint16_t);
+    size_t frame_size = line_size * self->display->height;
+
+    if (self->render_mode != LV_DISPLAY_RENDER_MODE_PARTIAL)
+    {
+        // DIRECT and FULL always render into full frame buffers
+        self->buf_size = frame_size;
+    }
+    else if (self->buffer_size > 0)
+    {
+        self->buf_size = LV_CLAMP(line_size, self->buffer_size / line_size * line_size, frame_size);
+    }
+    else if (self->buffer_lines > 0 && self->buffer_lines < self->display->height)
+    {
+        self->buf_size = self->buffer_lines * line_size;
+    }
+    else
+    {
+        self->buf_size = frame_size;
+    }
+
+    // Room for a line of the display turned a quarter, which LVGL needs after set_rotation()
+    self->buf_size = LV_MAX(self->buf_size, self->display->height * sizeof(uint16_t));
+
+    uint32_t caps = self->memory == LVGL_ESP32_MEMORY_DMA ? MALLOC_CAP_DMA : MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+
+    ESP_LOGI(TAG, "Creating %d display buffer(s) of %zu bytes", self->double_buffer ? 2 : 1, self->buf_size);
+    self->buf1 = heap_caps_malloc(self->buf_size, caps);
+    if (self->double_buffer)
+    {
+        self->buf2 = heap_caps_malloc(self->buf_size, caps);
+    }
+
+    if (self->buf1 == NULL || (self->double_buffer && self->buf2 == NULL))
+    {
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Could not allocate display buffers"));
+    }
+
+    if (self->memory == LVGL_ESP32_MEMORY_SPIRAM_BOUNCE)
+    {
+        self->bounce_size = LV_MIN(self->buf_size, BOUNCE_BUFFER_LINES * line_size);
+
+        ESP_LOGI(TAG, "Creating bounce buffers of %zu bytes", self->bounce_size);
+        for (int i = 0; i < 2; i++)
+        {
+            self->bounce_buf[i] = heap_caps_malloc(self->bounce_size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+            if (self->bounce_buf[i] == NULL)
+            {
+                mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Could not allocate bounce buffers"));
+            }
+            self->bounce_busy[i] = false;
+        }
+        self->bounce_last = false;
+        self->bounce_next = 0;
+        self->bounce_done = 0;
+    }
+    self->solid_pending = false;
+
+    if (self->tile_hash)
+    {
+        size_t size = tile_count(self) * sizeof(uint32_t);
+
+        ESP_LOGI(TAG, "Creating tile hash table of %zu bytes", size);
+        self->tile_hashes = heap_caps_calloc(1, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (self->tile_hashes == NULL)
+        {
+            mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Could not allocate tile hash table"));
+        }
+        self->tile_foreign_writes = self->display->foreign_writes;
+    }
+
+    self->flush_semaphore = xSemaphoreCreateBinary();
+    if (self->flush_semaphore == NULL)
+    {
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Could not create flush semaphore"));
+    }
+
+    // Flushes leave in pieces of bounce_size from the bounce buffers, or as a whole from the draw buffers
+    if (self->memory == LVGL_ESP32_MEMORY_SPIRAM_BOUNCE)
+    {
+        lvgl_esp32_Display_plan_bus(self->display, self->bounce_size, 2);
+    }
+    else
+    {
+        lvgl_esp32_Display_plan_bus(self->display, self->buf_size, self->double_buffer ? 2 : 1);
+    }
 
     // initialize LVGL draw buffers
-    lv_display_set_buffers(self->lv_display, self->buf1, self->buf2, self->buf_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_buffers(self->lv_display, self->buf1, self->buf2, self->buf_size, self->render_mode);
 
     ESP_LOGI(TAG, "Registering callback functions");
     self->display->transfer_done_cb = transfer_done_cb;
     self->display->transfer_done_user_data = (void *) self;
+    self->display->rotation_cb = rotation_cb;
+    self->display->rotation_user_data = (void *) self;
+    self->display->lock_cb = display_lock_cb;
+    self->display->unlock_cb = display_unlock_cb;
+    self->display->lock_user_data = (void *) self;
     lv_display_set_flush_cb(self->lv_display, flush_cb);
+    lv_display_set_flush_wait_cb(self->lv_display, flush_wait_cb);
     lv_display_set_user_data(self->lv_display, self);
+    if (self->coalesce)
+    {
+        lv_display_add_event_cb(self->lv_display, coalesce_refr_ready_cb, LV_EVENT_REFR_READY, self);
+    }
+    lv_display_add_event_cb(self->lv_display, invalidate_area_cb, LV_EVENT_INVALIDATE_AREA, self);
+    lv_display_add_event_cb(self->lv_display, stats_refr_start_cb, LV_EVENT_REFR_START, self);
+    lv_display_add_event_cb(self->lv_display, stats_refr_ready_cb, LV_EVENT_REFR_READY, self);
+    stats_reset(self);
     lv_tick_set_cb(tick_get_cb);
 
+#if LVGL_ESP32_USE_OS
+    if (self->render_task)
+    {
+        render_task_start(self);
+    }
+#endif
+}
+
+static mp_obj_t lvgl_esp32_Wrapper_deinit(mp_obj_t self_ptr);
+
+static mp_obj_t lvgl_esp32_Wrapper_init(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Wrapper_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    ESP_LOGI(TAG, "Initializing LVGL Wrapper");
+
+    // A setup that fails halfway is undone, so the display and buffers do not leak and init can be tried again
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0)
+    {
+        setup(self);
+        nlr_pop();
+    }
+    else
+    {
+        lvgl_esp32_Wrapper_deinit(self_ptr);
+        nlr_jump(nlr.ret_val);
+    }
+
     return mp_obj_new_int_from_uint(0);
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Wrapper_init_obj, lvgl_esp32_Wrapper_init);
@@ -70,10 +1205,32 @@ static mp_obj_t lvgl_esp32_Wrapper_deinit(mp_obj_t self_ptr)
 
     ESP_LOGI(TAG, "Deinitializing LVGL Wrapper");
 
+#if LVGL_ESP32_USE_OS
+    render_task_stop(self);
+#endif
+
     ESP_LOGI(TAG, "Disabling callback functions");
     lv_tick_set_cb(NULL);
     self->display->transfer_done_cb = NULL;
     self->display->transfer_done_user_data = NULL;
+    self->display->rotation_cb = NULL;
+    self->display->rotation_user_data = NULL;
+    self->display->lock_cb = NULL;
+    self->display->unlock_cb = NULL;
+    self->display->lock_user_data = NULL;
+
+    if (self->scroll_obj != NULL)
+    {
+        lv_obj_remove_event_cb_with_user_data(self->scroll_obj, scroll_cb, self);
+        lv_obj_remove_event_cb_with_user_data(self->scroll_obj, scroll_delete_cb, self);
+        self->scroll_obj = NULL;
+        self->scroll_pending = false;
+
+        if (self->display->io_handle != NULL && self->display->scroll_height > 0)
+        {
+            lvgl_esp32_Display_set_scroll_area(self->display, 0, 0);
+        }
+    }
 
     if (self->lv_display != NULL)
     {
@@ -96,16 +1253,383 @@ static mp_obj_t lvgl_esp32_Wrapper_deinit(mp_obj_t self_ptr)
         self->buf2 = NULL;
     }
 
+    self->bounce_size = 0;
+    for (int i = 0; i < 2; i++)
+    {
+        if (self->bounce_buf[i] != NULL)
+        {
+            ESP_LOGI(TAG, "Freeing bounce buffer");
+            heap_caps_free(self->bounce_buf[i]);
+            self->bounce_buf[i] = NULL;
+        }
+    }
+
+    if (self->tile_hashes != NULL)
+    {
+        ESP_LOGI(TAG, "Freeing tile hash table");
+        heap_caps_free(self->tile_hashes);
+        self->tile_hashes = NULL;
+    }
+
+    if (self->flush_semaphore != NULL)
+    {
+        vSemaphoreDelete(self->flush_semaphore);
+        self->flush_semaphore = NULL;
+    }
+
     if (lv_is_initialized())
     {
         ESP_LOGI(TAG, "Deinitializing LVGL");
         lv_deinit();
     }
 
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
+    // Free the pools of LVGL's allocator and let go of the Python objects that were kept for LVGL
+    heap_caps_free(mem_pool);
+    heap_caps_free(mem_pool_extra);
+    mem_pool = NULL;
+    mem_pool_extra = NULL;
+    MP_STATE_VM(mp_lv_refs) = MP_OBJ_NULL;
+#endif
+
     return mp_obj_new_int_from_uint(0);
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Wrapper_deinit_obj, lvgl_esp32_Wrapper_deinit);
 
+// Runs in the sweep of a GC, which only finds a running render task at a soft reset. Waiting for the task would
+// deadlock when it is in a callback that allocates, so it is only told to stop and LVGL is left as it is.
+static mp_obj_t lvgl_esp32_Wrapper___del__(mp_obj_t self_ptr)
+{
+#if LVGL_ESP32_USE_OS
+    lvgl_esp32_Wrapper_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    if (self->render_task_running)
+    {
+        self->render_task_stop = true;
+        return mp_obj_new_int_from_uint(0);
+    }
+#endif
+
+    return lvgl_esp32_Wrapper_deinit(self_ptr);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Wrapper___del___obj, lvgl_esp32_Wrapper___del__);
+
+// Takes the lock, returns an object whose context manager gives it back: `with wrapper.lock(): ...`. `with wrapper:`
+// takes the lock itself.
+static mp_obj_t lvgl_esp32_Wrapper_lock(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Wrapper_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    render_lock_take(self);
+
+    return self->lock_guard;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Wrapper_lock_obj, lvgl_esp32_Wrapper_lock);
+
+static mp_obj_t lvgl_esp32_Wrapper_unlock(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Wrapper_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    render_lock_give(self);
+
+    return mp_obj_new_int_from_uint(0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Wrapper_unlock_obj, lvgl_esp32_Wrapper_unlock);
+
+static mp_obj_t lvgl_esp32_Wrapper___enter__(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Wrapper_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    render_lock_take(self);
+
+    return self_ptr;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Wrapper___enter___obj, lvgl_esp32_Wrapper___enter__);
+
+static mp_obj_t lvgl_esp32_Wrapper___exit__(size_t n_args, const mp_obj_t *args)
+{
+    return lvgl_esp32_Wrapper_unlock(args[0]);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(lvgl_esp32_Wrapper___exit___obj, 4, 4, lvgl_esp32_Wrapper___exit__);
+
+typedef struct
+{
+    mp_obj_base_t base;
+    mp_obj_t wrapper;
+} lock_guard_obj_t;
+
+// The lock was taken by lock() already, entering the block only gives the guard back
+static mp_obj_t lock_guard___exit__(size_t n_args, const mp_obj_t *args)
+{
+    lock_guard_obj_t *guard = MP_OBJ_TO_PTR(args[0]);
+
+    return lvgl_esp32_Wrapper_unlock(guard->wrapper);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(lock_guard___exit___obj, 4, 4, lock_guard___exit__);
+
+static const mp_rom_map_elem_t lock_guard_locals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&mp_identity_obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&lock_guard___exit___obj) },
+};
+
+static MP_DEFINE_CONST_DICT(lock_guard_locals, lock_guard_locals_table);
+
+static MP_DEFINE_CONST_OBJ_TYPE(
+    lock_guard_type,
+    MP_QSTR_WrapperLock,
+    MP_TYPE_FLAG_NONE,
+    locals_dict,
+    &lock_guard_locals
+);
+
+static mp_obj_t lvgl_esp32_Wrapper_coalesce_stats(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Wrapper_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    mp_obj_t dict = mp_obj_new_dict(4);
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_areas), mp_obj_new_int_from_uint(self->coalesce_areas));
+    mp_obj_dict_store(
+        dict,
+        MP_OBJ_NEW_QSTR(MP_QSTR_transactions_saved),
+        mp_obj_new_int_from_uint(self->coalesce_merges)
+    );
+    mp_obj_dict_store(
+        dict,
+        MP_OBJ_NEW_QSTR(MP_QSTR_merged_pixels),
+        mp_obj_new_int_from_ull(self->coalesce_merged_pixels)
+    );
+    mp_obj_dict_store(
+        dict,
+        MP_OBJ_NEW_QSTR(MP_QSTR_extra_pixels),
+        mp_obj_new_int_from_ull(self->coalesce_extra_pixels)
+    );
+
+    return dict;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Wrapper_coalesce_stats_obj, lvgl_esp32_Wrapper_coalesce_stats);
+
+// Has the scroll area of the display do the vertical scrolling of a full width object, None stops it
+static mp_obj_t lvgl_esp32_Wrapper_hw_scroll(mp_obj_t self_ptr, mp_obj_t obj_in)
+{
+    lvgl_esp32_Wrapper_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    if (self->lv_display == NULL)
+    {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Wrapper is not initialized"));
+    }
+
+    if (self->scroll_obj != NULL)
+    {
+        lv_obj_remove_event_cb_with_user_data(self->scroll_obj, scroll_cb, self);
+        lv_obj_remove_event_cb_with_user_data(self->scroll_obj, scroll_delete_cb, self);
+        scroll_release(self);
+    }
+
+    if (obj_in == mp_const_none)
+    {
+        return mp_obj_new_int_from_uint(0);
+    }
+
+    lv_obj_t *obj = get_lv_obj(obj_in);
+
+    if (self->display->swap_xy || self->display->mirror_y)
+    {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Hardware scrolling needs swap_xy and mirror_y off"));
+    }
+
+    // DIRECT mode sends whole lines of its frame buffer, which does not scroll along
+    if (self->render_mode == LV_DISPLAY_RENDER_MODE_DIRECT)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Hardware scrolling does not work with RENDER_MODE_DIRECT"));
+    }
+
+    if (lv_obj_get_display(obj) != self->lv_display)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Object is not on this display"));
+    }
+
+    self->scroll_obj = obj;
+    self->scroll_y = lv_obj_get_scroll_y(obj);
+    lv_obj_add_event_cb(obj, scroll_cb, LV_EVENT_SCROLL, self);
+    lv_obj_add_event_cb(obj, scroll_delete_cb, LV_EVENT_DELETE, self);
+
+    return mp_obj_new_int_from_uint(0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(lvgl_esp32_Wrapper_hw_scroll_obj, lvgl_esp32_Wrapper_hw_scroll);
+
+// Frame timing relative to the TE pulses of the display, which are only known when it was given a TE pin
+static mp_obj_t lvgl_esp32_Wrapper_frame_stats(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Wrapper_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    mp_obj_t dict = mp_obj_new_dict(6);
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_frames), mp_obj_new_int_from_uint(self->frames));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_frames_late), mp_obj_new_int_from_uint(self->frames_late));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_frame_us), mp_obj_new_int_from_ll(self->frame_us));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_te_period_us), mp_obj_new_int_from_ll(self->display->te_period_us));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_te_timeouts), mp_obj_new_int_from_uint(self->te_timeouts));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_te_wait_us), mp_obj_new_int_from_ull(self->te_wait_us));
+
+    return dict;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Wrapper_frame_stats_obj, lvgl_esp32_Wrapper_frame_stats);
+
+static mp_obj_t histogram_dict(const lvgl_esp32_histogram_t *histogram)
+{
+    mp_obj_t buckets[LVGL_ESP32_HISTOGRAM_BUCKETS];
+    for (int i = 0; i < LVGL_ESP32_HISTOGRAM_BUCKETS; i++)
+    {
+        buckets[i] = mp_obj_new_int_from_uint(histogram->buckets[i]);
+    }
+
+    mp_obj_t dict = mp_obj_new_dict(4);
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_count), mp_obj_new_int_from_uint(histogram->count));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_total), mp_obj_new_int_from_ull(histogram->total));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_max), mp_obj_new_int_from_uint(histogram->max));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_buckets), mp_obj_new_tuple(LVGL_ESP32_HISTOGRAM_BUCKETS, buckets));
+
+    return dict;
+}
+
+// Counters and histograms of where the time of the frames since init() or reset_stats() went, and how often the
+// optimizations of the flush path kicked in
+static mp_obj_t lvgl_esp32_Wrapper_stats(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Wrapper_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    int64_t elapsed_us = esp_timer_get_time() - self->stats_start_us;
+    uint64_t bus_us = lvgl_esp32_Display_bus_time_us(self->display, self->display->color_bytes);
+
+    mp_obj_t dict = mp_obj_new_dict(18);
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_elapsed_us), mp_obj_new_int_from_ll(elapsed_us));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_refreshes), mp_obj_new_int_from_uint(self->stats_refreshes));
+    mp_obj_dict_store(
+        dict,
+        MP_OBJ_NEW_QSTR(MP_QSTR_fps),
+        mp_obj_new_float(elapsed_us > 0 ? self->render_us.count * 1000000.0f / elapsed_us : 0.0f)
+    );
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_bytes), mp_obj_new_int_from_ull(self->display->color_bytes));
+    mp_obj_dict_store(
+        dict,
+        MP_OBJ_NEW_QSTR(MP_QSTR_transactions),
+        mp_obj_new_int_from_uint(self->display->color_transactions)
+    );
+    mp_obj_dict_store(
+        dict,
+        MP_OBJ_NEW_QSTR(MP_QSTR_bus_utilisation),
+        mp_obj_new_float(elapsed_us > 0 ? (float) bus_us / elapsed_us : 0.0f)
+    );
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_render_us), histogram_dict(&self->render_us));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_flush_us), histogram_dict(&self->flush_us));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_swap_us), histogram_dict(&self->swap_us));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_wait_us), histogram_dict(&self->wait_us));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_flushes), histogram_dict(&self->flushes));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_solid_fills), mp_obj_new_int_from_uint(self->solid_fills));
+    mp_obj_dict_store(
+        dict,
+        MP_OBJ_NEW_QSTR(MP_QSTR_polled_flushes),
+        mp_obj_new_int_from_uint(self->display->polled_flushes)
+    );
+    mp_obj_dict_store(
+        dict,
+        MP_OBJ_NEW_QSTR(MP_QSTR_queued_flushes),
+        mp_obj_new_int_from_uint(self->display->queued_flushes)
+    );
+    mp_obj_dict_store(
+        dict,
+        MP_OBJ_NEW_QSTR(MP_QSTR_continued_writes),
+        mp_obj_new_int_from_uint(self->display->continued_writes)
+    );
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_hw_scrolls), mp_obj_new_int_from_uint(self->hw_scrolls));
+    mp_obj_dict_store(
+        dict,
+        MP_OBJ_NEW_QSTR(MP_QSTR_skipped_bytes),
+        mp_obj_new_int_from_ull(self->tile_skipped_bytes)
+    );
+
+    return dict;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Wrapper_stats_obj, lvgl_esp32_Wrapper_stats);
+
+static mp_obj_t lvgl_esp32_Wrapper_reset_stats(mp_obj_t self_ptr)
+{
+    lvgl_esp32_Wrapper_obj_t *self = MP_OBJ_TO_PTR(self_ptr);
+
+    stats_reset(self);
+
+    return mp_obj_new_int_from_uint(0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Wrapper_reset_stats_obj, lvgl_esp32_Wrapper_reset_stats);
+
+// Usage of the memory pool of LVGL, only there when LVGL does not allocate from the MicroPython heap
+static mp_obj_t lvgl_esp32_Wrapper_mem_stats(mp_obj_t self_ptr)
+{
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
+    if (!lv_is_initialized())
+    {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("Wrapper is not initialized"));
+    }
+
+    lv_mem_monitor_t monitor;
+    lv_mem_monitor(&monitor);
+
+    mp_obj_t dict = mp_obj_new_dict(8);
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_total_size), mp_obj_new_int_from_uint(monitor.total_size));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_free_size), mp_obj_new_int_from_uint(monitor.free_size));
+    mp_obj_dict_store(
+        dict,
+        MP_OBJ_NEW_QSTR(MP_QSTR_free_biggest_size),
+        mp_obj_new_int_from_uint(monitor.free_biggest_size)
+    );
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_max_used), mp_obj_new_int_from_uint(monitor.max_used));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_used_cnt), mp_obj_new_int_from_uint(monitor.used_cnt));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_free_cnt), mp_obj_new_int_from_uint(monitor.free_cnt));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_used_pct), mp_obj_new_int_from_uint(monitor.used_pct));
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(MP_QSTR_frag_pct), mp_obj_new_int_from_uint(monitor.frag_pct));
+
+    return dict;
+#else
+    mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("LVGL allocates from the MicroPython heap in this build"));
+#endif
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Wrapper_mem_stats_obj, lvgl_esp32_Wrapper_mem_stats);
+
+// Records LVGL's profiler points and the spans of this module until trace_stop(), the ring is shared by all wrappers
+static mp_obj_t lvgl_esp32_Wrapper_trace_start(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args)
+{
+    enum
+    {
+        ARG_events,         // number of events kept, the oldest ones are overwritten
+    };
+
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_events, MP_ARG_INT, { .u_int = 1024 }},
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    lvgl_esp32_trace_start(args[ARG_events].u_int);
+
+    return mp_obj_new_int_from_uint(0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(lvgl_esp32_Wrapper_trace_start_obj, 1, lvgl_esp32_Wrapper_trace_start);
+
+static mp_obj_t lvgl_esp32_Wrapper_trace_stop(mp_obj_t self_ptr)
+{
+    lvgl_esp32_trace_stop();
+
+    return mp_obj_new_int_from_uint(0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(lvgl_esp32_Wrapper_trace_stop_obj, lvgl_esp32_Wrapper_trace_stop);
+
+// Chrome trace event JSON as loaded by Perfetto and chrome://tracing, written to a stream or returned as a str
+static mp_obj_t lvgl_esp32_Wrapper_trace_dump(size_t n_args, const mp_obj_t *args)
+{
+    return lvgl_esp32_trace_dump(n_args > 1 ? args[1] : mp_const_none);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(lvgl_esp32_Wrapper_trace_dump_obj, 1, 2, lvgl_esp32_Wrapper_trace_dump);
+
 static mp_obj_t lvgl_esp32_Wrapper_make_new(
     const mp_obj_type_t *type,
     size_t n_args,
@@ -115,11 +1639,37 @@ static mp_obj_t lvgl_esp32_Wrapper_make_new(
 {
     enum
     {
-        ARG_display,      // a display instance
+        ARG_display,              // a display instance
+        ARG_buffer_lines,         // height of the draw buffers in lines, 0 for a full frame
+        ARG_buffer_size,          // size of the draw buffers in bytes, overrides buffer_lines
+        ARG_double_buffer,        // allocate a second draw buffer so rendering and sending can overlap
+        ARG_render_mode,          // one of the RENDER_MODE_* constants
+        ARG_memory,               // one of the MEMORY_* constants
+        ARG_coalesce,             // merge invalidated areas when that is cheaper to send
+        ARG_coalesce_overhead,    // cost of a transaction in bytes when deciding to merge areas
+        ARG_solid_fill,           // send single color areas from the fill pattern of the display
+        ARG_tile_hash,            // only send the tiles of a flush that changed since they were last sent
+        ARG_render_task,          // run lv_timer_handler() in a task of its own
+        ARG_render_core,          // core to pin the render task to, -1 for the one MicroPython is not using
+        ARG_mem_size,             // total size of the memory pool of LVGL, 0 for LV_MEM_SIZE
+        ARG_mem_region,           // one of the MEM_* constants, where the memory pool of LVGL is allocated
     };
 
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_display, MP_ARG_OBJ | MP_ARG_REQUIRED },
+        { MP_QSTR_buffer_lines, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 20 }},
+        { MP_QSTR_buffer_size, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 0 }},
+        { MP_QSTR_double_buffer, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = true }},
+        { MP_QSTR_render_mode, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = LV_DISPLAY_RENDER_MODE_PARTIAL }},
+        { MP_QSTR_memory, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = LVGL_ESP32_MEMORY_DMA }},
+        { MP_QSTR_coalesce, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false }},
+        { MP_QSTR_coalesce_overhead, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 512 }},
+        { MP_QSTR_solid_fill, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false }},
+        { MP_QSTR_tile_hash, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false }},
+        { MP_QSTR_render_task, MP_ARG_BOOL | MP_ARG_KW_ONLY, { .u_bool = false }},
+        { MP_QSTR_render_core, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = -1 }},
+        { MP_QSTR_mem_size, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = 0 }},
+        { MP_QSTR_mem_region, MP_ARG_INT | MP_ARG_KW_ONLY, { .u_int = LVGL_ESP32_MEM_INTERNAL }},
     };
 
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
@@ -134,19 +1684,176 @@ static mp_obj_t lvgl_esp32_Wrapper_make_new(
 
     self->display = (lvgl_esp32_Display_obj_t *) MP_OBJ_TO_PTR(args[ARG_display].u_obj);
 
+    if (args[ARG_buffer_lines].u_int < 0
+        || args[ARG_buffer_lines].u_int > UINT16_MAX
+        || args[ARG_buffer_size].u_int < 0)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid buffer size"));
+    }
+
+    mp_int_t render_mode = args[ARG_render_mode].u_int;
+    if (render_mode != LV_DISPLAY_RENDER_MODE_PARTIAL
+        && render_mode != LV_DISPLAY_RENDER_MODE_DIRECT
+        && render_mode != LV_DISPLAY_RENDER_MODE_FULL)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid render mode"));
+    }
+
+    mp_int_t memory = args[ARG_memory].u_int;
+    if (memory < LVGL_ESP32_MEMORY_DMA || memory > LVGL_ESP32_MEMORY_SPIRAM_BOUNCE)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid memory type"));
+    }
+
+    // DIRECT mode keeps the frame in the draw buffers, so the pixels can not be byte-swapped or packed in place
+    if (render_mode == LV_DISPLAY_RENDER_MODE_DIRECT
+        && (self->display->swap_bytes || self->display->rgb444)
+        && memory != LVGL_ESP32_MEMORY_SPIRAM_BOUNCE)
+    {
+        mp_raise_ValueError(
+            MP_ERROR_TEXT("DIRECT render mode with swap_bytes/rgb444 requires memory=MEMORY_SPIRAM_BOUNCE")
+        );
+    }
+
+    self->buffer_lines = args[ARG_buffer_lines].u_int;
+    self->buffer_size = args[ARG_buffer_size].u_int;
+    self->double_buffer = args[ARG_double_buffer].u_bool;
+    self->render_mode = render_mode;
+    self->memory = memory;
+
+    if (args[ARG_coalesce_overhead].u_int < 0)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid coalesce overhead"));
+    }
+
+    self->coalesce = args[ARG_coalesce].u_bool;
+    self->coalesce_overhead = args[ARG_coalesce_overhead].u_int;
+    self->coalesce_areas = 0;
+    self->coalesce_merges = 0;
+    self->coalesce_merged_pixels = 0;
+    self->coalesce_extra_pixels = 0;
+    self->coalesce_count = 0;
+
+    self->solid_fill = args[ARG_solid_fill].u_bool;
+    self->solid_pending = false;
+    self->solid_fills = 0;
+
+    // Unchanged columns are cut out of the draw buffer in place, which neither the frame buffer of DIRECT mode nor the
+    // chunks of the bounce buffers allow
+    if (args[ARG_tile_hash].u_bool
+        && (render_mode == LV_DISPLAY_RENDER_MODE_DIRECT || memory == LVGL_ESP32_MEMORY_SPIRAM_BOUNCE))
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("tile_hash does not work with DIRECT render mode or bounce buffers"));
+    }
+
+    self->tile_hash = args[ARG_tile_hash].u_bool;
+    self->tile_hashes = NULL;
+    self->flush_semaphore = NULL;
+    self->tile_foreign_writes = 0;
+    self->tile_skipped_bytes = 0;
+
+    self->frame_start = true;
+    self->frame_last_flush = false;
+    self->frame_te_us = 0;
+    self->frame_us = 0;
+    self->frames = 0;
+    self->frames_late = 0;
+    self->te_timeouts = 0;
+    self->te_wait_us = 0;
+
+#if !LVGL_ESP32_USE_OS
+    if (args[ARG_render_task].u_bool)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Render task requires a build with LVGL_ESP32_USE_OS"));
+    }
+#endif
+
+    if (args[ARG_render_core].u_int < -1 || args[ARG_render_core].u_int > 1)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid render core"));
+    }
+
+    self->render_task = args[ARG_render_task].u_bool;
+    self->render_core = args[ARG_render_core].u_int;
+#if LVGL_ESP32_USE_OS
+    self->render_task_running = false;
+    self->render_task_stop = false;
+    self->render_lock_depth = 0;
+#endif
+
+    lock_guard_obj_t *guard = mp_obj_malloc(lock_guard_obj_t, &lock_guard_type);
+    guard->wrapper = MP_OBJ_FROM_PTR(self);
+    self->lock_guard = MP_OBJ_FROM_PTR(guard);
+
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
+    if (args[ARG_mem_size].u_int != 0 && args[ARG_mem_size].u_int < LV_MEM_SIZE)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("mem_size can not be less than LV_MEM_SIZE"));
+    }
+    if (args[ARG_mem_region].u_int != LVGL_ESP32_MEM_INTERNAL && args[ARG_mem_region].u_int != LVGL_ESP32_MEM_SPIRAM)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid memory region"));
+    }
+#else
+    if (args[ARG_mem_size].u_int != 0)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("mem_size requires a build with LVGL_ESP32_MEM_POOL"));
+    }
+
+    if (args[ARG_mem_region].u_int != LVGL_ESP32_MEM_INTERNAL)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("mem_region requires a build with LVGL_ESP32_MEM_POOL"));
+    }
+#endif
+    self->mem_size = args[ARG_mem_size].u_int;
+    self->mem_region = args[ARG_mem_region].u_int;
+
     self->buf_size = 0;
     self->buf1 = NULL;
     self->buf2 = NULL;
 
+    self->bounce_size = 0;
+    self->bounce_buf[0] = NULL;
+    self->bounce_buf[1] = NULL;
+
     self->lv_display = NULL;
+    stats_reset(self);
+
+    self->scroll_obj = NULL;
+    self->scroll_y = 0;
+    self->scroll_pending = false;
+    self->hw_scrolls = 0;
 
     return MP_OBJ_FROM_PTR(self);
 }
 
 static const mp_rom_map_elem_t lvgl_esp32_Wrapper_locals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_init), MP_ROM_PTR(&lvgl_esp32_Wrapper_init_obj) },
-    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&lvgl_esp32_Wrapper_deinit_obj) },
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&lvgl_esp32_Wrapper___del___obj) },
     { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&lvgl_esp32_Wrapper_deinit_obj) },
+    { MP_ROM_QSTR(MP_QSTR_coalesce_stats), MP_ROM_PTR(&lvgl_esp32_Wrapper_coalesce_stats_obj) },
+    { MP_ROM_QSTR(MP_QSTR_frame_stats), MP_ROM_PTR(&lvgl_esp32_Wrapper_frame_stats_obj) },
+    { MP_ROM_QSTR(MP_QSTR_hw_scroll), MP_ROM_PTR(&lvgl_esp32_Wrapper_hw_scroll_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stats), MP_ROM_PTR(&lvgl_esp32_Wrapper_stats_obj) },
+    { MP_ROM_QSTR(MP_QSTR_reset_stats), MP_ROM_PTR(&lvgl_esp32_Wrapper_reset_stats_obj) },
+    { MP_ROM_QSTR(MP_QSTR_mem_stats), MP_ROM_PTR(&lvgl_esp32_Wrapper_mem_stats_obj) },
+    { MP_ROM_QSTR(MP_QSTR_trace_start), MP_ROM_PTR(&lvgl_esp32_Wrapper_trace_start_obj) },
+    { MP_ROM_QSTR(MP_QSTR_trace_stop), MP_ROM_PTR(&lvgl_esp32_Wrapper_trace_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_trace_dump), MP_ROM_PTR(&lvgl_esp32_Wrapper_trace_dump_obj) },
+    { MP_ROM_QSTR(MP_QSTR_lock), MP_ROM_PTR(&lvgl_esp32_Wrapper_lock_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unlock), MP_ROM_PTR(&lvgl_esp32_Wrapper_unlock_obj) },
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&lvgl_esp32_Wrapper___enter___obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&lvgl_esp32_Wrapper___exit___obj) },
+
+    { MP_ROM_QSTR(MP_QSTR_RENDER_MODE_PARTIAL), MP_ROM_INT(LV_DISPLAY_RENDER_MODE_PARTIAL) },
+    { MP_ROM_QSTR(MP_QSTR_RENDER_MODE_DIRECT), MP_ROM_INT(LV_DISPLAY_RENDER_MODE_DIRECT) },
+    { MP_ROM_QSTR(MP_QSTR_RENDER_MODE_FULL), MP_ROM_INT(LV_DISPLAY_RENDER_MODE_FULL) },
+
+    { MP_ROM_QSTR(MP_QSTR_MEMORY_DMA), MP_ROM_INT(LVGL_ESP32_MEMORY_DMA) },
+    { MP_ROM_QSTR(MP_QSTR_MEMORY_SPIRAM), MP_ROM_INT(LVGL_ESP32_MEMORY_SPIRAM) },
+    { MP_ROM_QSTR(MP_QSTR_MEMORY_SPIRAM_BOUNCE), MP_ROM_INT(LVGL_ESP32_MEMORY_SPIRAM_BOUNCE) },
+    { MP_ROM_QSTR(MP_QSTR_MEM_INTERNAL), MP_ROM_INT(LVGL_ESP32_MEM_INTERNAL) },
+    { MP_ROM_QSTR(MP_QSTR_MEM_SPIRAM), MP_ROM_INT(LVGL_ESP32_MEM_SPIRAM) },
 };
 
 static MP_DEFINE_CONST_DICT(lvgl_esp32_Wrapper_locals, lvgl_esp32_Wrapper_locals_table);
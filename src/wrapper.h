@@ -6,16 +6,136 @@
 #include "lvgl.h"
 #include "py/obj.h"
 
+typedef enum
+{
+    LVGL_ESP32_MEMORY_DMA,              // internal DMA-capable memory
+    LVGL_ESP32_MEMORY_SPIRAM,           // SPIRAM, sent as is
+    LVGL_ESP32_MEMORY_SPIRAM_BOUNCE,    // SPIRAM, copied to internal bounce buffers before sending
+} lvgl_esp32_memory_t;
+
+typedef enum
+{
+    LVGL_ESP32_MEM_INTERNAL,            // internal RAM
+    LVGL_ESP32_MEM_SPIRAM,              // SPIRAM
+} lvgl_esp32_mem_region_t;
+
+// Power of two histogram of durations in microseconds or of counts. Bucket 0 holds 0, bucket i the values from 2^(i-1)
+// up to 2^i - 1 and the last one everything above.
+#define LVGL_ESP32_HISTOGRAM_BUCKETS 16
+
+typedef struct
+{
+    uint32_t count;
+    uint64_t total;
+    uint32_t max;
+    uint32_t buckets[LVGL_ESP32_HISTOGRAM_BUCKETS];
+} lvgl_esp32_histogram_t;
+
 typedef struct lvgl_esp32_Wrapper_obj_t
 {
     mp_obj_base_t base;
     lvgl_esp32_Display_obj_t *display;
 
+    // Requested configuration
+    uint16_t buffer_lines;
+    size_t buffer_size;
+    bool double_buffer;
+    lv_display_render_mode_t render_mode;
+    lvgl_esp32_memory_t memory;
+
+    // Draw buffers, buf_size is in bytes
     size_t buf_size;
     uint16_t *buf1;
     uint16_t *buf2;
 
+    // Bounce buffers for LVGL_ESP32_MEMORY_SPIRAM_BOUNCE, used in turns and released by the transfer done callback
+    size_t bounce_size;
+    uint16_t *bounce_buf[2];
+    volatile bool bounce_busy[2];
+    volatile bool bounce_last;
+    uint8_t bounce_next;
+    uint8_t bounce_done;
+
+    // Given by the transfer done callback, waits for a draw or bounce buffer block on it instead of spinning
+    SemaphoreHandle_t flush_semaphore;
+
+    // Dirty area coalescing, the overhead is the cost of an extra transaction expressed in bytes
+    bool coalesce;
+    uint32_t coalesce_overhead;
+    uint32_t coalesce_areas;
+    uint32_t coalesce_merges;
+    uint64_t coalesce_merged_pixels;
+    uint64_t coalesce_extra_pixels;
+
+    // Bounding boxes of the areas invalidated since the last refresh, as far as they fit
+    lv_area_t coalesce_boxes[LV_INV_BUF_SIZE];
+    uint32_t coalesce_count;
+
+    // Areas of a single color are sent with a fill instead of from the draw buffer. solid_pending marks the flush in
+    // progress as such a fill, which used no bounce buffer.
+    bool solid_fill;
+    volatile bool solid_pending;
+    uint32_t solid_fills;
+
+    // Hashes of the tiles of the screen as they were last sent, 0 when unknown. Flushed tiles that hash the same are
+    // not sent again, tile_skipped_bytes counts the RGB565 bytes that saved.
+    bool tile_hash;
+    uint32_t *tile_hashes;
+    uint32_t tile_foreign_writes;
+    uint64_t tile_skipped_bytes;
+
+    // Frame timing against the TE pulses of the display, frame_us runs from the pulse to the end of the last transfer
+    bool frame_start;
+    volatile bool frame_last_flush;
+    int64_t frame_te_us;
+    volatile int64_t frame_us;
+    volatile uint32_t frames;
+    volatile uint32_t frames_late;
+    uint32_t te_timeouts;
+    uint64_t te_wait_us;
+
+    // Statistics since stats_start_us, see stats(). Rendering is the time of a refresh that was not spent in flush_cb
+    // or waiting for a flush, only refreshes that flushed something count as frames.
+    int64_t stats_start_us;
+    uint32_t stats_refreshes;
+    lvgl_esp32_histogram_t render_us;
+    lvgl_esp32_histogram_t flush_us;
+    lvgl_esp32_histogram_t swap_us;
+    lvgl_esp32_histogram_t wait_us;
+    lvgl_esp32_histogram_t flushes;
+    int64_t refr_start_us;
+    int64_t refr_other_us;
+    uint32_t refr_flushes;
+
     lv_display_t *lv_display;
+
+    // Vertical scrolling of scroll_obj moves the scroll area of the display. From a scroll until the object invalidated
+    // itself scroll_pending is set, that invalidation is then cut down to the rows that came in, scroll_exposed.
+    lv_obj_t *scroll_obj;
+    int32_t scroll_y;
+    bool scroll_pending;
+    lv_area_t scroll_exposed;
+    uint32_t hw_scrolls;
+
+    // Size LVGL's memory pool is grown to at init() and where it lives, when it does not allocate from the MicroPython
+    // heap
+    size_t mem_size;
+    lvgl_esp32_mem_region_t mem_region;
+
+    // Task running lv_timer_handler() next to the MicroPython one, render_lock guards all access to LVGL while it runs
+    bool render_task;
+    int8_t render_core;
+#if LVGL_ESP32_USE_OS
+    volatile bool render_task_running;
+    volatile bool render_task_stop;
+    lv_mutex_t render_lock;
+
+    // Times lock() took render_lock that were not given back yet, so unlock() only gives what was taken
+    uint32_t render_lock_depth;
+#endif
+
+    // Returned by lock(), so `with wrapper.lock():` gives back the lock taken by lock() itself
+    mp_obj_t lock_guard;
 } lvgl_esp32_Wrapper_obj_t;
 
 extern const mp_obj_type_t lvgl_esp32_Wrapper_type;